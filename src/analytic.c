@@ -0,0 +1,283 @@
+/* Estimates the results of a Post Office branch from queueing theory,
+instantly and without simulating it. */
+#include <analytic.h>
+
+/* Finds the long run behaviour of a queue with the given rates per minute of
+arrivals, of serving each customer and of each waiting customer leaving,
+with a number of service points and a capacity of customers being served or
+waiting, which is -1 for no limit. The chance of each number of customers
+is built up one after another from the balance between arrivals and
+leaving. An arriving customer sees the branch as it is on average, and
+follows the customers ahead of them through the line, where each leaves
+early at the rate of abandonment, until they are served or leave early
+themselves. The time to clear the branch is how long it takes the customers
+there to leave with no more arriving. The rate of serving each customer
+must be finite. */
+void find_steady_state(double arrival_rate, double service_rate,
+                       double abandonment_rate, int num_service_points,
+                       long capacity, STEADY_STATE *state)
+{
+    double chance = 1, total = 0, admitted = 0, served = 0, waiting = 0;
+    double wait = 0, busy = 0, clearing = 0, blocked = 0;
+    double served_from = 1, wait_from = 0, clearing_time = 0;
+    long customers;
+
+    for (customers = 0; chance > 0; customers++)
+    {
+        long ahead = customers - num_service_points;
+        int num_busy = ahead < 0 ? customers : num_service_points;
+        double leaving = num_busy * service_rate;
+        if (ahead > 0)
+        {
+            leaving += ahead * abandonment_rate;
+        }
+        if (customers > 0)
+        {
+            clearing_time += 1 / leaving;
+        }
+
+        total += chance;
+        busy += chance * num_busy;
+        clearing += chance * clearing_time;
+
+        /* Customers arriving when the branch is full are turned away. */
+        if (customers == capacity)
+        {
+            blocked = chance;
+            break;
+        }
+
+        /* Customers arriving to a free service point are served straight
+        away, and others are served if every customer ahead of them and the
+        one being served before them leaves before they do. */
+        admitted += chance;
+        if (ahead < 0)
+        {
+            served += chance;
+        }
+        else
+        {
+            double moving = num_service_points * service_rate +
+                            ahead * abandonment_rate;
+            double rate = moving + abandonment_rate;
+            wait_from = moving / rate * (served_from / rate + wait_from);
+            served_from *= moving / rate;
+            served += chance * served_from;
+            wait += chance * wait_from;
+            waiting += chance;
+        }
+
+        /* Finds the chance of one more customer, stopping once more are
+        negligibly likely or impossible, which leaves the chance of the
+        branch being full as 0. */
+        double next_leaving = (ahead + 1 < 0 ? customers + 1
+                                             : num_service_points) *
+                              service_rate;
+        if (ahead + 1 > 0)
+        {
+            next_leaving += (ahead + 1) * abandonment_rate;
+        }
+        if (customers + 1 == MAX_ANALYTIC_STATES ||
+            (next_leaving > arrival_rate &&
+             chance < ANALYTIC_TOLERANCE * total))
+        {
+            break;
+        }
+        chance *= arrival_rate / next_leaving;
+
+        /* Scales every sum down if the chances become too large to
+        hold. */
+        if (chance > ANALYTIC_RESCALE)
+        {
+            chance /= ANALYTIC_RESCALE;
+            total /= ANALYTIC_RESCALE;
+            admitted /= ANALYTIC_RESCALE;
+            served /= ANALYTIC_RESCALE;
+            waiting /= ANALYTIC_RESCALE;
+            wait /= ANALYTIC_RESCALE;
+            busy /= ANALYTIC_RESCALE;
+            clearing /= ANALYTIC_RESCALE;
+        }
+    }
+
+    state->blocking = blocked / total;
+    state->waiting = waiting / total;
+    state->abandonment = (admitted - served) / total;
+    state->mean_wait = served > 0 ? wait / served : 0;
+    state->utilisation = busy / total / num_service_points;
+    state->clearing_time = clearing / total;
+}
+
+/* Finds the mean of the whole numbers of minutes drawn from the Gaussian
+distribution with the given mean and standard deviation, which is about
+half a minute less than the mean as each number is truncated. */
+double find_whole_minutes_mean(int mean, int std_dev)
+{
+    VARIATE_GENERATOR generator;
+    generator.kind = GAUSSIAN_VARIATE;
+    generator.mean = mean;
+    generator.std_dev = std_dev;
+    if (std_dev <= 0)
+    {
+        return mean;
+    }
+
+    /* Adds up the chance of each number being exceeded. */
+    double total = 0;
+    int value;
+    for (value = 0; value <= mean + VARIATE_TABLE_SPREAD * std_dev; value++)
+    {
+        total += 1 - find_variate_cumulative(&generator, value);
+    }
+    return total;
+}
+
+/* Estimates the averages of a day at the branch, treating the task lengths
+and tolerances as exponential, with the means of the whole minutes they are
+drawn as, and every class as one. The mean task length is weighted by how
+often each class arrives, as is the rate each class leaves the queue early,
+which is 0 for a class which never does. Each
+segment of the arrival schedule is taken to reach its steady state, and the
+time after closing is the time to clear the branch as it is in the last
+segment. Every customer waits in the queue first, so none are served
+without room in it. */
+void estimate_branch(PARAMETERS *params, ESTIMATE *estimate)
+{
+    ARRIVAL_SCHEDULE *schedule = &params->schedule;
+    int num_service_points = params->num_service_points;
+    double opening_hours = params->closing_time + 1;
+
+    /* Weights the classes by their rates of arrival. */
+    double arrival_rate = 0, mean_mins = 0, abandonment_rate = 0;
+    int customer_class;
+    for (customer_class = 0; customer_class < params->num_classes;
+         customer_class++)
+    {
+        CUSTOMER_CLASS *current = &params->classes[customer_class];
+        double tolerance = find_whole_minutes_mean(
+            current->mean_tolerance, current->std_dev_tolerance);
+        arrival_rate += current->avg_customer_rate;
+        mean_mins += current->avg_customer_rate *
+                     find_whole_minutes_mean(current->mean_mins,
+                                             current->std_dev_mins);
+        if (current->mean_tolerance > 0 && tolerance > 0)
+        {
+            abandonment_rate += current->avg_customer_rate / tolerance;
+        }
+    }
+    if (arrival_rate > 0)
+    {
+        mean_mins /= arrival_rate;
+        abandonment_rate /= arrival_rate;
+    }
+    double service_rate = mean_mins > 0 ? 1 / mean_mins : HUGE_VAL;
+
+    long capacity = -1;
+    if (params->max_queue_length == 0)
+    {
+        capacity = 0;
+    }
+    else if (params->max_queue_length != INT_MAX)
+    {
+        capacity = (long)num_service_points + params->max_queue_length;
+    }
+
+    estimate->num_customers = 0;
+    estimate->num_fulfilled = 0;
+    estimate->num_unfulfilled = 0;
+    estimate->num_timed_out = 0;
+    estimate->mean_wait = 0;
+    estimate->time_after_closing = 0;
+    estimate->blocking = 0;
+    estimate->waiting = 0;
+    estimate->abandonment = 0;
+    estimate->utilisation = 0;
+
+    int segment;
+    for (segment = 0; segment < schedule->num_segments &&
+                      schedule->starts[segment] < opening_hours;
+         segment++)
+    {
+        double end = opening_hours;
+        if (segment + 1 < schedule->num_segments &&
+            schedule->starts[segment + 1] < end)
+        {
+            end = schedule->starts[segment + 1];
+        }
+        double length = end - schedule->starts[segment];
+        double rate = arrival_rate * schedule->multiples[segment];
+        double serving_rate = num_service_points * service_rate;
+
+        /* Customers whose tasks take no time never wait, as every service
+        point is always free, unless the queue has no room for them. */
+        STEADY_STATE state;
+        if (service_rate == HUGE_VAL)
+        {
+            state.blocking = capacity == 0 ? 1 : 0;
+            state.waiting = 0;
+            state.abandonment = 0;
+            state.mean_wait = 0;
+            state.utilisation = 0;
+            state.clearing_time = 0;
+        }
+        else if (capacity < 0 && abandonment_rate == 0 &&
+                 rate >= serving_rate)
+        {
+            /* A queue which never turns anyone away and which customers
+            never leave has no steady state once they arrive faster than
+            they can be served, so it is taken to grow steadily over the
+            segment. */
+            double growth = (rate - serving_rate) * length;
+            state.blocking = 0;
+            state.waiting = 1;
+            state.abandonment = 0;
+            state.mean_wait = growth / 2 / serving_rate;
+            state.utilisation = 1;
+            state.clearing_time = growth / serving_rate;
+        }
+        else
+        {
+            find_steady_state(rate, service_rate, abandonment_rate,
+                              num_service_points, capacity, &state);
+        }
+
+        double customers = rate * length;
+        double fulfilled = customers * (1 - state.blocking -
+                                        state.abandonment);
+        estimate->num_customers += customers;
+        estimate->num_fulfilled += fulfilled;
+        estimate->num_unfulfilled += customers * state.blocking;
+        estimate->num_timed_out += customers * state.abandonment;
+        estimate->mean_wait += fulfilled * state.mean_wait;
+        estimate->time_after_closing = state.clearing_time;
+        estimate->blocking += customers * state.blocking;
+        estimate->waiting += customers * state.waiting;
+        estimate->abandonment += customers * state.abandonment;
+        estimate->utilisation += length * state.utilisation;
+    }
+
+    /* Turns the totals over the day into averages. */
+    if (estimate->num_fulfilled > 0)
+    {
+        estimate->mean_wait /= estimate->num_fulfilled;
+    }
+    if (estimate->num_customers > 0)
+    {
+        estimate->blocking /= estimate->num_customers;
+        estimate->waiting /= estimate->num_customers;
+        estimate->abandonment /= estimate->num_customers;
+    }
+    estimate->utilisation /= opening_hours;
+}
+
+/* Estimates the averages of a day at the branch and outputs them. */
+void output_branch_estimate(OUTPUT *output, PARAMETERS *params)
+{
+    ESTIMATE estimate;
+    estimate_branch(params, &estimate);
+    output_estimate(output, estimate.num_fulfilled, estimate.num_unfulfilled,
+                    estimate.num_timed_out, estimate.mean_wait,
+                    estimate.time_after_closing, estimate.blocking,
+                    estimate.waiting, estimate.abandonment,
+                    estimate.utilisation);
+}
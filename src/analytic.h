@@ -0,0 +1,57 @@
+/* Header file for estimating the results of a Post Office branch from
+queueing theory, instantly and without simulating it. */
+#ifndef __ANALYTIC_H
+#define __ANALYTIC_H
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <customer.h>
+#include <input_output.h>
+#include <random_numbers.h>
+#include <simulation.h>
+
+/* Most numbers of customers whose chances are added up before the chance of
+any more is taken to be negligible. */
+#define MAX_ANALYTIC_STATES 10000000L
+
+/* Chance of a number of customers, relative to those before it, below which
+no more customers are followed, once they leave faster than they arrive. */
+#define ANALYTIC_TOLERANCE 1e-15
+
+/* Size the chances of the states are scaled down by when they grow too
+large to be held. */
+#define ANALYTIC_RESCALE 1e200
+
+/* Steady state structure holding the long run behaviour of an M/M/c/K queue
+where waiting customers leave at an exponential rate, which is Erlang-C
+without the limit or abandonment and Erlang-A with abandonment. The
+chances are those of an arriving customer, and the waiting time is the
+average of those who are served. */
+struct steady_state
+{
+    double blocking, waiting, abandonment, mean_wait, utilisation,
+        clearing_time;
+};
+typedef struct steady_state STEADY_STATE;
+
+/* Estimate structure holding the averages of a day at the branch found
+from queueing theory, in the same form as the results of simulating it,
+along with the chances for an average customer. */
+struct estimate
+{
+    double num_customers, num_fulfilled, num_unfulfilled, num_timed_out,
+        mean_wait, time_after_closing;
+    double blocking, waiting, abandonment, utilisation;
+};
+typedef struct estimate ESTIMATE;
+
+/* Analytic function prototypes. */
+void find_steady_state(double, double, double, int, long, STEADY_STATE *);
+double find_whole_minutes_mean(int, int);
+void estimate_branch(PARAMETERS *, ESTIMATE *);
+void output_branch_estimate(OUTPUT *, PARAMETERS *);
+
+#endif
@@ -0,0 +1,123 @@
+/* Handles arenas, which hand out memory for the state of a simulation and are
+reset all at once before the next simulation. */
+#include <arena.h>
+
+/* Creates an arena with a single block of the given size, or returns NULL
+if there is not enough memory. */
+ARENA *create_arena(size_t size)
+{
+    ARENA *arena = (ARENA *)malloc(sizeof(ARENA));
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    arena->num_heap_allocations = 1;
+    arena->num_resets = 0;
+    if (!(arena->blocks = create_arena_block(arena, size, NULL)))
+    {
+        free(arena);
+        return NULL;
+    }
+
+    return arena;
+}
+
+/* Takes a new block of memory from the heap and puts it at the front of the
+list of blocks, counting the allocations made. Returns NULL if there is not
+enough memory. */
+ARENA_BLOCK *create_arena_block(ARENA *arena, size_t size, ARENA_BLOCK *next)
+{
+    ARENA_BLOCK *block = (ARENA_BLOCK *)malloc(sizeof(ARENA_BLOCK));
+    if (block == NULL)
+    {
+        return NULL;
+    }
+    if (!(block->memory = (char *)malloc(size)))
+    {
+        free(block);
+        return NULL;
+    }
+
+    block->size = size;
+    block->used = 0;
+    block->next = next;
+    arena->num_heap_allocations += 2;
+
+    return block;
+}
+
+/* Hands out memory from the current block, only going to the heap for a new
+block if it does not have enough space left. Returns NULL if there is not
+enough memory for a new block. */
+void *arena_allocate(ARENA *arena, size_t size)
+{
+    /* Rounds the size up so the next piece of memory is aligned. */
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+    ARENA_BLOCK *block = arena->blocks;
+    if (block->used + size > block->size)
+    {
+        size_t new_size = 2 * block->size;
+        if (new_size < size)
+        {
+            new_size = size;
+        }
+        if (!(block = create_arena_block(arena, new_size, block)))
+        {
+            return NULL;
+        }
+        arena->blocks = block;
+    }
+
+    void *memory = block->memory + block->used;
+    block->used += size;
+
+    return memory;
+}
+
+/* Makes all of the memory in the arena available again. If the last
+simulation needed more than one block, they are replaced by a single block
+as big as all of them, so that the next simulation fits without going to
+the heap. The blocks are kept as they are if there is not enough memory for
+the single block. */
+void reset_arena(ARENA *arena)
+{
+    arena->num_resets++;
+
+    if (arena->blocks->next != NULL)
+    {
+        size_t size = 0;
+        ARENA_BLOCK *block;
+        for (block = arena->blocks; block != NULL; block = block->next)
+        {
+            size += block->size;
+        }
+        if ((block = create_arena_block(arena, size, NULL)) != NULL)
+        {
+            free_arena_blocks(arena->blocks);
+            arena->blocks = block;
+        }
+    }
+
+    arena->blocks->used = 0;
+}
+
+/* Frees a list of blocks and the memory of each. */
+void free_arena_blocks(ARENA_BLOCK *blocks)
+{
+    while (blocks != NULL)
+    {
+        ARENA_BLOCK *block = blocks;
+        blocks = block->next;
+        free(block->memory);
+        free(block);
+    }
+}
+
+/* Frees the memory used by the arena and all of its blocks. */
+void free_arena(ARENA *arena)
+{
+    free_arena_blocks(arena->blocks);
+    free(arena);
+}
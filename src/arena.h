@@ -0,0 +1,45 @@
+/* Header file for handling arenas, which hand out memory for the state of a
+simulation and are reset all at once before the next simulation. */
+#ifndef __ARENA_H
+#define __ARENA_H
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Memory is handed out in multiples of this many bytes, so that it is
+suitably aligned for any type. */
+#define ARENA_ALIGNMENT 16
+
+/* Size in bytes of the arena a simulation starts with, which grows to fit
+the largest simulation it has run. */
+#define ARENA_SIZE 65536
+
+/* Block structure, for one piece of memory taken from the heap. */
+struct arena_block
+{
+    char *memory;
+    size_t size, used;
+    struct arena_block *next;
+};
+typedef struct arena_block ARENA_BLOCK;
+
+/* Arena structure, with the block memory is currently handed out from at the
+front of the list of blocks. */
+struct arena
+{
+    ARENA_BLOCK *blocks;
+    long num_heap_allocations, num_resets;
+};
+typedef struct arena ARENA;
+
+/* Arena function prototypes. */
+ARENA *create_arena(size_t);
+ARENA_BLOCK *create_arena_block(ARENA *, size_t, ARENA_BLOCK *);
+void *arena_allocate(ARENA *, size_t);
+void reset_arena(ARENA *);
+void free_arena_blocks(ARENA_BLOCK *);
+void free_arena(ARENA *);
+
+#endif
@@ -0,0 +1,233 @@
+/* Saves the progress of many simulations to a checkpoint file, so that a run
+which is stopped can be resumed from it. */
+#include <checkpoint.h>
+
+/* Creates a checkpoint for a run with the given options and parameters,
+before any simulations have finished. */
+void create_checkpoint(CHECKPOINT *checkpoint, OPTIONS *options,
+                       PARAMETERS *params)
+{
+    checkpoint->checkpoint_file = options->checkpoint_file;
+    if (!(checkpoint->temporary_file = (char *)malloc(
+              strlen(options->checkpoint_file) + 5)))
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    sprintf(checkpoint->temporary_file, "%s.tmp", options->checkpoint_file);
+
+    checkpoint->interval = options->checkpoint_interval;
+    checkpoint->last_saved = 0;
+
+    CHECKPOINT_HEADER *header = &checkpoint->header;
+    memset(header, 0, sizeof(CHECKPOINT_HEADER));
+    memcpy(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic));
+    header->version = CHECKPOINT_VERSION;
+    header->results_size = sizeof(RESULTS);
+    header->num_simulations = options->num_simulations;
+    header->event_driven = options->event_driven;
+    header->antithetic = options->antithetic;
+    header->resolution = options->resolution;
+    header->precision = options->precision;
+    header->seed = options->seed;
+    header->params = *params;
+    header->num_finished = 0;
+    header->batch_first = 0;
+    header->batch_size = 0;
+}
+
+/* Frees the memory used by a checkpoint, leaving its file in place. */
+void free_checkpoint(CHECKPOINT *checkpoint)
+{
+    free(checkpoint->temporary_file);
+}
+
+/* Records the first simulation and size of the batch being run. */
+void start_checkpoint_batch(CHECKPOINT *checkpoint, int batch_first,
+                            int batch_size)
+{
+    checkpoint->header.batch_first = batch_first;
+    checkpoint->header.batch_size = batch_size;
+}
+
+/* Writes the checkpoint once the given number of simulations have finished,
+if at least the interval between checkpoints has passed since the last
+one. Returns an error code if it cannot be written. */
+int save_checkpoint(CHECKPOINT *checkpoint, int num_finished,
+                    RESULTS *results)
+{
+    if (num_finished - checkpoint->last_saved >= checkpoint->interval)
+    {
+        return write_checkpoint(checkpoint, num_finished, results);
+    }
+
+    return SIMQ_OK;
+}
+
+/* Writes the checkpoint with the totals of the given number of simulations
+to a temporary file, then moves it over the checkpoint file, so a run
+stopped while writing leaves the last checkpoint whole. Returns an error
+code if it cannot be written. */
+int write_checkpoint(CHECKPOINT *checkpoint, int num_finished,
+                     RESULTS *results)
+{
+    FILE *fp;
+
+    checkpoint->header.num_finished = num_finished;
+    checkpoint->last_saved = num_finished;
+
+    if ((fp = fopen(checkpoint->temporary_file, "wb")) == NULL)
+    {
+        return SIMQ_ERROR_FILE;
+    }
+
+    if (fwrite(&checkpoint->header, sizeof(CHECKPOINT_HEADER), 1, fp) != 1 ||
+        fwrite(results, sizeof(RESULTS), 1, fp) != 1)
+    {
+        fclose(fp);
+        return SIMQ_ERROR_FILE;
+    }
+
+    if (fclose(fp) != 0 ||
+        rename(checkpoint->temporary_file, checkpoint->checkpoint_file) != 0)
+    {
+        return SIMQ_ERROR_FILE;
+    }
+
+    return SIMQ_OK;
+}
+
+/* Opens a checkpoint file and reads its header, checking that it was
+written in this format and with totals of the same size. */
+FILE *read_checkpoint_header(char *checkpoint_file, CHECKPOINT_HEADER *header)
+{
+    FILE *fp;
+
+    if ((fp = fopen(checkpoint_file, "rb")) == NULL)
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    if (fread(header, sizeof(CHECKPOINT_HEADER), 1, fp) != 1 ||
+        memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != CHECKPOINT_VERSION ||
+        header->results_size != sizeof(RESULTS))
+    {
+        fprintf(stderr, "%s is not a checkpoint of this version!\n",
+                checkpoint_file);
+        exit(EXIT_FAILURE);
+    }
+
+    return fp;
+}
+
+/* Takes the seed of the run being resumed from its checkpoint, unless a
+different one was given. */
+void read_checkpoint_seed(OPTIONS *options)
+{
+    CHECKPOINT_HEADER header;
+    fclose(read_checkpoint_header(options->checkpoint_file, &header));
+
+    if (options->seeded && header.seed != options->seed)
+    {
+        fprintf(stderr, "The run must be resumed with the seed it was "
+                        "started with!\n");
+        exit(EXIT_FAILURE);
+    }
+    options->seed = header.seed;
+}
+
+/* Checks if two sets of parameters have the same values, classes of
+customer and arrival schedule, comparing the names of the classes only up
+to their terminating null. */
+int same_parameters(PARAMETERS *a, PARAMETERS *b)
+{
+    int customer_class, segment;
+
+    if (a->max_queue_length != b->max_queue_length ||
+        a->num_service_points != b->num_service_points ||
+        a->closing_time != b->closing_time ||
+        a->num_classes != b->num_classes ||
+        a->avg_customer_rate != b->avg_customer_rate ||
+        a->mean_mins != b->mean_mins || a->std_dev_mins != b->std_dev_mins ||
+        a->mean_tolerance != b->mean_tolerance ||
+        a->std_dev_tolerance != b->std_dev_tolerance ||
+        a->schedule.num_segments != b->schedule.num_segments)
+    {
+        return 0;
+    }
+
+    for (customer_class = 0; customer_class < a->num_classes;
+         customer_class++)
+    {
+        CUSTOMER_CLASS *x = &a->classes[customer_class];
+        CUSTOMER_CLASS *y = &b->classes[customer_class];
+        if (strcmp(x->name, y->name) != 0 ||
+            x->avg_customer_rate != y->avg_customer_rate ||
+            x->mean_mins != y->mean_mins ||
+            x->std_dev_mins != y->std_dev_mins ||
+            x->mean_tolerance != y->mean_tolerance ||
+            x->std_dev_tolerance != y->std_dev_tolerance ||
+            x->priority != y->priority)
+        {
+            return 0;
+        }
+    }
+
+    for (segment = 0; segment < a->schedule.num_segments; segment++)
+    {
+        if (a->schedule.starts[segment] != b->schedule.starts[segment] ||
+            a->schedule.multiples[segment] != b->schedule.multiples[segment])
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* Reads the checkpoint file back into a checkpoint created with the same
+options, seed and parameters, giving the totals of the simulations it had
+finished. */
+void read_checkpoint(CHECKPOINT *checkpoint, RESULTS *results)
+{
+    CHECKPOINT_HEADER header;
+    FILE *fp = read_checkpoint_header(checkpoint->checkpoint_file, &header);
+
+    if (fread(results, sizeof(RESULTS), 1, fp) != 1)
+    {
+        fprintf(stderr, "%s is too short to be a checkpoint!\n",
+                checkpoint->checkpoint_file);
+        exit(EXIT_FAILURE);
+    }
+    fclose(fp);
+
+    /* Checks the run was started with the same options, which decide the
+    simulations run and the batches they are split into. */
+    CHECKPOINT_HEADER *expected = &checkpoint->header;
+    if (header.num_simulations != expected->num_simulations ||
+        header.event_driven != expected->event_driven ||
+        header.antithetic != expected->antithetic ||
+        header.resolution != expected->resolution ||
+        header.precision != expected->precision ||
+        header.seed != expected->seed)
+    {
+        fprintf(stderr, "The run must be resumed with the same number of "
+                        "simulations and options it was started with!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Checks the input file has not changed since, as the totals would
+    otherwise mix the results of different branches. */
+    if (!same_parameters(&header.params, &expected->params))
+    {
+        fprintf(stderr, "The run must be resumed with the same parameters, "
+                        "classes of customer and arrival schedule it was "
+                        "started with!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    *expected = header;
+    checkpoint->last_saved = header.num_finished;
+}
@@ -0,0 +1,57 @@
+/* Header file for saving the progress of many simulations to a checkpoint
+file, so that a run which is stopped can be resumed from it. */
+#ifndef __CHECKPOINT_H
+#define __CHECKPOINT_H
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <errors.h>
+#include <options.h>
+#include <simulation.h>
+
+/* Identifies a file as a checkpoint, followed by the version of the
+format. */
+#define CHECKPOINT_MAGIC "SIMQCKPT"
+#define CHECKPOINT_VERSION 5
+
+/* Header structure at the start of a checkpoint, holding the size of the
+totals which follow it, the options and parameters the run must be resumed
+with, the number of simulations whose results have been added onto the
+totals, and the first simulation and size of the batch they are in. */
+struct checkpoint_header
+{
+    char magic[8];
+    int version, results_size;
+    int num_simulations, event_driven, antithetic;
+    float resolution, precision;
+    unsigned long seed;
+    PARAMETERS params;
+    int num_finished, batch_first, batch_size;
+};
+typedef struct checkpoint_header CHECKPOINT_HEADER;
+
+/* Checkpoint structure holding the header of the latest checkpoint, which is
+followed in its file by the totals of the simulations it has finished. */
+struct checkpoint
+{
+    char *checkpoint_file, *temporary_file;
+    int interval, last_saved;
+    CHECKPOINT_HEADER header;
+};
+typedef struct checkpoint CHECKPOINT;
+
+/* Checkpoint function prototypes. */
+void create_checkpoint(CHECKPOINT *, OPTIONS *, PARAMETERS *);
+void free_checkpoint(CHECKPOINT *);
+void start_checkpoint_batch(CHECKPOINT *, int, int);
+int save_checkpoint(CHECKPOINT *, int, RESULTS *);
+int write_checkpoint(CHECKPOINT *, int, RESULTS *);
+FILE *read_checkpoint_header(char *, CHECKPOINT_HEADER *);
+void read_checkpoint_seed(OPTIONS *);
+int same_parameters(PARAMETERS *, PARAMETERS *);
+void read_checkpoint(CHECKPOINT *, RESULTS *);
+
+#endif
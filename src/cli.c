@@ -0,0 +1,54 @@
+/* Handles the errors returned by the simulation library for the command line
+programs, which stop with a message instead of carrying on. */
+#include <cli.h>
+
+/* Stops the program with a message if an error code is not success, for
+programs which cannot carry on after any error. */
+void exit_on_error(int error)
+{
+    if (error == SIMQ_OK)
+    {
+        return;
+    }
+
+    if (error == SIMQ_ERROR_MEMORY || error == SIMQ_ERROR_FILE)
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+    }
+    else if (error == SIMQ_ERROR_PARAMETERS)
+    {
+        fprintf(stderr, "You have input an invalid parameter value! "
+                        "\nmaxQueueLength must be at least -1, which "
+                        "removes the limit.\naverageCustomersPerMinute, "
+                        "meanMinsPerCustomerTask, "
+                        "standardDeviationMinsPerCustomerTask, "
+                        "meanMaxQueueTimePerCustomer, and "
+                        "standardDeviationMaxQueueTimePerCustomer must be at "
+                        "least 0.\nnumServicePoints and closingTime must be "
+                        "at least 1.");
+    }
+    else if (error == SIMQ_ERROR_CLASSES)
+    {
+        fprintf(stderr, "Each customerClass must have a name followed by "
+                        "its average customers per minute, mean and "
+                        "standard deviation of task length, and mean "
+                        "and standard deviation of tolerance, which must "
+                        "be at least 0, then its priority. There can be "
+                        "at most %d classes.\n",
+                MAX_CUSTOMER_CLASSES - 1);
+    }
+    else if (error == SIMQ_ERROR_SCHEDULE)
+    {
+        fprintf(stderr, "Each arrivalSchedule must have the minute it "
+                        "starts, after the one before, followed by the "
+                        "multiple of the average rates customers arrive at, "
+                        "which must be at least 0. There can be at most %d "
+                        "segments.\n",
+                MAX_SCHEDULE_SEGMENTS);
+    }
+    else
+    {
+        fprintf(stderr, "%s!\n", simq_error_message(error));
+    }
+    exit(EXIT_FAILURE);
+}
@@ -0,0 +1,18 @@
+/* Header file for handling the errors returned by the simulation library for
+the command line programs. */
+#ifndef __CLI_H
+#define __CLI_H
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <customer.h>
+#include <errors.h>
+#include <libsimq.h>
+
+/* Command line function prototypes. */
+void exit_on_error(int);
+
+#endif
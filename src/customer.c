@@ -1,23 +1,187 @@
 /* Creates new customers. */
 #include <customer.h>
 
-/* Creates a new linked list node to represent a customer. */
-CUSTOMER *create_new_customer(int mean_mins, int std_dev_mins,
-                              int mean_tolerance, int std_dev_tolerance,
-                              gsl_rng *r)
+/* Creates a new customer with a random task length and tolerance, taken
+from the generators of each. */
+CUSTOMER create_new_customer(VARIATE_GENERATOR *mins_generator,
+                             VARIATE_GENERATOR *tolerance_generator)
 {
-    CUSTOMER *customer = (CUSTOMER *)malloc(sizeof(CUSTOMER));
-    if (customer == NULL)
+    CUSTOMER customer;
+
+    customer.mins = next_variate(mins_generator);
+    customer.tolerance = next_variate(tolerance_generator);
+
+    return customer;
+}
+
+/* Reads the extra classes of customer from the input file, adding them
+after the given number of classes, which is increased to the new number.
+Each class is on a line starting with customerClass, followed by its name,
+average customers per minute, mean and standard deviation of the task
+length, mean and standard deviation of the tolerance, and priority. Returns
+an error code if the file cannot be opened or any class is invalid. */
+int read_customer_classes(char *input_parameters, CUSTOMER_CLASS *classes,
+                          int *num_classes)
+{
+    FILE *fp;
+    char word[64];
+
+    /* Opens the parameter file to read from it. */
+    if ((fp = fopen(input_parameters, "r")) == NULL)
     {
-        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
-        exit(EXIT_FAILURE);
+        return SIMQ_ERROR_FILE;
     }
 
-    customer->mins = generate_random_gaussian(mean_mins, std_dev_mins, r);
-    customer->time_waited = 0;
-    customer->tolerance = generate_random_gaussian(mean_tolerance,
-                                                   std_dev_tolerance, r);
-    customer->next = NULL;
+    while (fscanf(fp, "%63s", word) == 1)
+    {
+        if (strcmp(word, "customerClass") != 0)
+        {
+            continue;
+        }
 
-    return customer;
+        /* Checks there is room for the class and its values are valid. */
+        CUSTOMER_CLASS *current = &classes[*num_classes];
+        float values[6];
+        if (*num_classes == MAX_CUSTOMER_CLASSES ||
+            fscanf(fp, "%31s %f %f %f %f %f %f", current->name, &values[0],
+                   &values[1], &values[2], &values[3], &values[4],
+                   &values[5]) != 7 ||
+            values[0] < 0 || values[1] < 0 || values[2] < 0 ||
+            values[3] < 0 || values[4] < 0)
+        {
+            fclose(fp);
+            return SIMQ_ERROR_CLASSES;
+        }
+
+        current->avg_customer_rate = values[0];
+        current->mean_mins = values[1];
+        current->std_dev_mins = values[2];
+        current->mean_tolerance = values[3];
+        current->std_dev_tolerance = values[4];
+        current->priority = values[5];
+        (*num_classes)++;
+    }
+
+    fclose(fp);
+    return SIMQ_OK;
+}
+
+/* Finds the priority level of each class, where 0 is the highest priority
+and classes with the same priority share a level, returning the number of
+levels. */
+int find_priority_levels(CUSTOMER_CLASS *classes, int num_classes,
+                         int *levels)
+{
+    int num_levels = 0;
+    int customer_class, other;
+    for (customer_class = 0; customer_class < num_classes; customer_class++)
+    {
+        /* Counts the distinct priorities higher than that of the class. */
+        levels[customer_class] = 0;
+        for (other = 0; other < num_classes; other++)
+        {
+            int priority = classes[other].priority;
+            int earlier;
+            for (earlier = 0; earlier < other; earlier++)
+            {
+                if (classes[earlier].priority == priority)
+                {
+                    break;
+                }
+            }
+            if (earlier == other &&
+                priority > classes[customer_class].priority)
+            {
+                levels[customer_class]++;
+            }
+        }
+
+        if (levels[customer_class] + 1 > num_levels)
+        {
+            num_levels = levels[customer_class] + 1;
+        }
+    }
+
+    return num_levels;
+}
+
+/* Sets a schedule with customers arriving at their average rate all day. */
+void create_constant_schedule(ARRIVAL_SCHEDULE *schedule)
+{
+    schedule->num_segments = 1;
+    schedule->starts[0] = 0;
+    schedule->multiples[0] = 1;
+}
+
+/* Checks if a schedule changes the rates customers arrive at at all. */
+int has_arrival_schedule(ARRIVAL_SCHEDULE *schedule)
+{
+    return schedule->num_segments > 1 || schedule->multiples[0] != 1;
+}
+
+/* Reads the arrival schedule from the input file, where each segment is on
+a line starting with arrivalSchedule, followed by the minute it starts and
+the multiple of the average rates customers arrive at from then on. The
+segments must be in order of their start, and the rates are the average
+until the first unless it starts at minute 0. Returns an error code if the
+file cannot be opened or any segment is invalid. */
+int read_arrival_schedule(char *input_parameters, ARRIVAL_SCHEDULE *schedule)
+{
+    FILE *fp;
+    char word[64];
+    int start, num_read = 0;
+    float multiple;
+
+    create_constant_schedule(schedule);
+
+    /* Opens the parameter file to read from it. */
+    if ((fp = fopen(input_parameters, "r")) == NULL)
+    {
+        return SIMQ_ERROR_FILE;
+    }
+
+    while (fscanf(fp, "%63s", word) == 1)
+    {
+        if (strcmp(word, "arrivalSchedule") != 0)
+        {
+            continue;
+        }
+
+        /* Checks the segment starts after the one before and has a valid
+        multiple, and that there is room for it unless it replaces the
+        first. */
+        int last = schedule->num_segments - 1;
+        if (fscanf(fp, "%d %f", &start, &multiple) != 2 || multiple < 0 ||
+            start < 0 || (start <= schedule->starts[last] && num_read > 0) ||
+            (start > 0 && schedule->num_segments == MAX_SCHEDULE_SEGMENTS))
+        {
+            fclose(fp);
+            return SIMQ_ERROR_SCHEDULE;
+        }
+
+        if (start > 0)
+        {
+            last = schedule->num_segments++;
+        }
+        schedule->starts[last] = start;
+        schedule->multiples[last] = multiple;
+        num_read++;
+    }
+
+    fclose(fp);
+    return SIMQ_OK;
+}
+
+/* Finds the segment of an arrival schedule a time is in, searching onwards
+from a segment which does not start after it. */
+int find_schedule_segment(ARRIVAL_SCHEDULE *schedule, int segment,
+                          double time)
+{
+    while (segment + 1 < schedule->num_segments &&
+           schedule->starts[segment + 1] <= time)
+    {
+        segment++;
+    }
+
+    return segment;
 }
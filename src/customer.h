@@ -9,15 +9,66 @@
 #include <stdlib.h>
 #include <string.h>
 
-/* Customer structure using a linked list, acting as a node. */
+#include <errors.h>
+#include <random_numbers.h>
+
+/* Most classes of customer a branch can have, including the standard class
+from the main parameters of the input file. */
+#define MAX_CUSTOMER_CLASSES 8
+
+/* Longest name of a class of customer, including the terminating null. */
+#define CLASS_NAME_LENGTH 32
+
+/* Most segments the arrival schedule of a branch can have, including the
+first, which starts at opening. */
+#define MAX_SCHEDULE_SEGMENTS 32
+
+/* Customer structure, which is stored in the queue field by field. */
 struct customer
 {
-    int mins, time_waited, tolerance;
-    struct customer *next;
+    int mins, tolerance;
 };
 typedef struct customer CUSTOMER;
 
+/* Customer class structure, for a kind of customer with their own rate of
+arrival, task length and tolerance. Waiting customers of a class with a
+higher priority are always served first. */
+struct customer_class
+{
+    char name[CLASS_NAME_LENGTH];
+    float avg_customer_rate;
+    int mean_mins, std_dev_mins, mean_tolerance, std_dev_tolerance, priority;
+};
+typedef struct customer_class CUSTOMER_CLASS;
+
+/* Arrival schedule structure, which splits the opening hours into segments
+from each start minute until the next, where customers of every class
+arrive at the given multiple of their average rate. Without a schedule,
+there is a single segment with a multiple of 1. */
+struct arrival_schedule
+{
+    int num_segments;
+    int starts[MAX_SCHEDULE_SEGMENTS];
+    float multiples[MAX_SCHEDULE_SEGMENTS];
+};
+typedef struct arrival_schedule ARRIVAL_SCHEDULE;
+
+/* Class results structure holding the running totals of a single class of
+customer. */
+struct class_results
+{
+    long num_customers, num_fulfilled, num_unfulfilled, num_timed_out;
+    double fulfilled_wait_time;
+};
+typedef struct class_results CLASS_RESULTS;
+
 /* Customer function prototypes. */
-CUSTOMER *create_new_customer(int, int, int, int, gsl_rng *);
+CUSTOMER create_new_customer(VARIATE_GENERATOR *, VARIATE_GENERATOR *);
+int read_customer_classes(char *, CUSTOMER_CLASS *, int *);
+int find_priority_levels(CUSTOMER_CLASS *, int, int *);
+void create_constant_schedule(ARRIVAL_SCHEDULE *);
+int has_arrival_schedule(ARRIVAL_SCHEDULE *);
+int read_arrival_schedule(char *, ARRIVAL_SCHEDULE *);
+int find_schedule_segment(ARRIVAL_SCHEDULE *, int, double);
 
 #endif
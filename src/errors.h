@@ -0,0 +1,17 @@
+/* Header file for the error codes the simulation returns instead of exiting,
+so that it can be run within another program. */
+#ifndef __ERRORS_H
+#define __ERRORS_H
+
+/* Error codes, where 0 is success. Memory and file errors leave errno set
+by the call which failed. */
+#define SIMQ_OK 0
+#define SIMQ_ERROR_MEMORY 1
+#define SIMQ_ERROR_FILE 2
+#define SIMQ_ERROR_PARAMETERS 3
+#define SIMQ_ERROR_CLASSES 4
+#define SIMQ_ERROR_FINISHED 5
+#define SIMQ_ERROR_SCHEDULE 6
+#define NUM_SIMQ_ERRORS 7
+
+#endif
@@ -0,0 +1,226 @@
+/* Handles the future events of the event-driven simulation, which are kept in
+a binary heap ordered by time. */
+#include <events.h>
+
+/* Creates an empty list of events with room for a few to start with, or
+returns NULL if there is not enough memory. */
+EVENT_LIST *create_event_list(ARENA *arena)
+{
+    EVENT_LIST *list = (EVENT_LIST *)arena_allocate(arena,
+                                                    sizeof(EVENT_LIST));
+    if (list == NULL)
+    {
+        return NULL;
+    }
+
+    list->arena = arena;
+    list->max_events = 16;
+    list->num_events = 0;
+    list->num_scheduled = 0;
+    list->events = (EVENT *)arena_allocate(arena,
+                                           list->max_events * sizeof(EVENT));
+    if (list->events == NULL)
+    {
+        return NULL;
+    }
+
+    return list;
+}
+
+/* Checks if the first event should be handled before the second. Events at
+the same time are handled by type, and then in the order they were
+scheduled. */
+int is_earlier_event(EVENT *first, EVENT *second)
+{
+    if (first->time != second->time)
+    {
+        return first->time < second->time;
+    }
+    if (first->type != second->type)
+    {
+        return first->type < second->type;
+    }
+    return first->order < second->order;
+}
+
+/* Adds an event to the list, moving it up the heap to its place. Returns an
+error code if there is not enough memory for it. */
+int schedule_event(EVENT_LIST *list, double time, int type, int customer,
+                    int customer_class)
+{
+    /* Doubles the space for events if the list is full. */
+    if (list->num_events == list->max_events)
+    {
+        EVENT *events = (EVENT *)arena_allocate(
+            list->arena, 2 * list->max_events * sizeof(EVENT));
+        if (events == NULL)
+        {
+            return SIMQ_ERROR_MEMORY;
+        }
+        memcpy(events, list->events, list->num_events * sizeof(EVENT));
+        list->events = events;
+        list->max_events *= 2;
+    }
+
+    EVENT event;
+    event.time = time;
+    event.type = type;
+    event.customer = customer;
+    event.customer_class = customer_class;
+    event.order = list->num_scheduled++;
+
+    /* Moves parents down until the new event is not earlier than its
+    parent. */
+    int position = list->num_events++;
+    while (position > 0)
+    {
+        int parent = (position - 1) / 2;
+        if (!is_earlier_event(&event, &list->events[parent]))
+        {
+            break;
+        }
+        list->events[position] = list->events[parent];
+        position = parent;
+    }
+    list->events[position] = event;
+
+    return SIMQ_OK;
+}
+
+/* Takes the earliest event from the list, returning 0 if there are none. */
+int next_event(EVENT_LIST *list, EVENT *event)
+{
+    if (list->num_events == 0)
+    {
+        return 0;
+    }
+
+    *event = list->events[0];
+    EVENT last = list->events[--list->num_events];
+
+    /* Moves the earlier child up until the last event fits in the gap. */
+    int position = 0;
+    while (1)
+    {
+        int child = 2 * position + 1;
+        if (child >= list->num_events)
+        {
+            break;
+        }
+        if (child + 1 < list->num_events &&
+            is_earlier_event(&list->events[child + 1], &list->events[child]))
+        {
+            child++;
+        }
+        if (!is_earlier_event(&list->events[child], &last))
+        {
+            break;
+        }
+        list->events[position] = list->events[child];
+        position = child;
+    }
+    list->events[position] = last;
+
+    return 1;
+}
+
+/* Creates an empty waiting line for customers to join, or returns NULL if
+there is not enough memory. */
+WAITING_LINE *create_waiting_line(ARENA *arena)
+{
+    WAITING_LINE *line = (WAITING_LINE *)arena_allocate(arena,
+                                                        sizeof(WAITING_LINE));
+    if (line == NULL)
+    {
+        return NULL;
+    }
+
+    line->arena = arena;
+    line->max_customers = 16;
+    line->front = line->rear = 0;
+    line->first_customer = 0;
+    line->queue_length = 0;
+    line->customers = (EVENT_CUSTOMER *)arena_allocate(
+        arena, line->max_customers * sizeof(EVENT_CUSTOMER));
+    if (line->customers == NULL)
+    {
+        return NULL;
+    }
+
+    return line;
+}
+
+/* Adds a customer of a class onto the end of the waiting line, returning the
+number which identifies them, or -1 if there is not enough memory. */
+int join_waiting_line(WAITING_LINE *line, double joined, int mins,
+                      int tolerance, int customer_class)
+{
+    if (line->rear == line->max_customers)
+    {
+        /* Reuses the space of customers who have left the front. */
+        if (line->front > 0)
+        {
+            memmove(line->customers, line->customers + line->front,
+                    (line->rear - line->front) * sizeof(EVENT_CUSTOMER));
+            line->first_customer += line->front;
+            line->rear -= line->front;
+            line->front = 0;
+        }
+
+        /* Doubles the space for customers if it is still full. */
+        if (line->rear == line->max_customers)
+        {
+            EVENT_CUSTOMER *customers = (EVENT_CUSTOMER *)arena_allocate(
+                line->arena, 2 * line->max_customers * sizeof(EVENT_CUSTOMER));
+            if (customers == NULL)
+            {
+                return -1;
+            }
+            memcpy(customers, line->customers,
+                   line->rear * sizeof(EVENT_CUSTOMER));
+            line->customers = customers;
+            line->max_customers *= 2;
+        }
+    }
+
+    EVENT_CUSTOMER *customer = &line->customers[line->rear];
+    customer->joined = joined;
+    customer->mins = mins;
+    customer->tolerance = tolerance;
+    customer->waiting = 1;
+    customer->customer_class = customer_class;
+    line->queue_length++;
+
+    return line->first_customer + line->rear++;
+}
+
+/* Finds a customer by their number if they are still waiting in the line. */
+EVENT_CUSTOMER *find_waiting_customer(WAITING_LINE *line, int number)
+{
+    int position = number - line->first_customer;
+    if (position < line->front || position >= line->rear ||
+        !line->customers[position].waiting)
+    {
+        return NULL;
+    }
+
+    return &line->customers[position];
+}
+
+/* Takes the customer at the front of the line, skipping past any who have
+already left, and returns NULL if no one is waiting. */
+EVENT_CUSTOMER *leave_waiting_line(WAITING_LINE *line)
+{
+    while (line->front < line->rear)
+    {
+        EVENT_CUSTOMER *customer = &line->customers[line->front++];
+        if (customer->waiting)
+        {
+            customer->waiting = 0;
+            line->queue_length--;
+            return customer;
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,73 @@
+/* Header file for handling the future events of the event-driven simulation,
+which are kept in a binary heap ordered by time. */
+#ifndef __EVENTS_H
+#define __EVENTS_H
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <arena.h>
+#include <errors.h>
+
+/* Types of event, in the order they are handled when they happen at the same
+time, which is that of the phases of a time slice: a customer starts being
+served once those who arrived or finished have, and before anyone leaves
+early. */
+#define ARRIVAL 0
+#define DEPARTURE 1
+#define START 2
+#define ABANDONMENT 3
+
+/* Event structure, for something which will happen to a customer of a
+class. */
+struct event
+{
+    double time;
+    int type, customer, customer_class;
+    long order;
+};
+typedef struct event EVENT;
+
+/* Event list structure as a binary heap, with the next event at the top. */
+struct event_list
+{
+    EVENT *events;
+    int num_events, max_events;
+    long num_scheduled;
+    ARENA *arena;
+};
+typedef struct event_list EVENT_LIST;
+
+/* Customer structure for the event-driven simulation, remembering when they
+joined the queue instead of counting the minutes they have waited. */
+struct event_customer
+{
+    double joined;
+    int mins, tolerance, waiting, customer_class;
+};
+typedef struct event_customer EVENT_CUSTOMER;
+
+/* Waiting line structure holding customers in the order they joined. Each
+customer keeps the same number for the whole simulation, which is their
+position in the array plus the number of customers removed from the start. */
+struct waiting_line
+{
+    EVENT_CUSTOMER *customers;
+    int front, rear, max_customers, first_customer, queue_length;
+    ARENA *arena;
+};
+typedef struct waiting_line WAITING_LINE;
+
+/* Event function prototypes. */
+EVENT_LIST *create_event_list(ARENA *);
+int is_earlier_event(EVENT *, EVENT *);
+int schedule_event(EVENT_LIST *, double, int, int, int);
+int next_event(EVENT_LIST *, EVENT *);
+WAITING_LINE *create_waiting_line(ARENA *);
+int join_waiting_line(WAITING_LINE *, double, int, int, int);
+EVENT_CUSTOMER *find_waiting_customer(WAITING_LINE *, int);
+EVENT_CUSTOMER *leave_waiting_line(WAITING_LINE *);
+
+#endif
@@ -1,24 +1,16 @@
 /* Handles input and output. */
 #include <input_output.h>
 
-/* Reads a file to get parameters for the simulation. */
-float *read_parameter_file(char *input_parameters)
+/* Reads a file to get parameters for the simulation, returning an error code
+if it cannot be opened or any value is invalid. */
+int read_parameter_file(char *input_parameters, float *parameters)
 {
     FILE *fp;
 
-    /* Allocates memory to store the parameters. */
-    float *parameters = NULL;
-    if (!(parameters = (float *)malloc(9 * sizeof(float))))
-    {
-        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
-        exit(EXIT_FAILURE);
-    };
-
     /* Opens the parameter file to read from it. */
     if ((fp = fopen(input_parameters, "r")) == NULL)
     {
-        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
-        exit(EXIT_FAILURE);
+        return SIMQ_ERROR_FILE;
     }
 
     /* Searches for the parameters in the text file. */
@@ -32,133 +24,522 @@ float *read_parameter_file(char *input_parameters)
     fscanf(fp, "\nstandardDeviationMaxQueueTimePerCustomer %f",
            &parameters[7]);
 
-    /* Checks that parameters have valid values. */
-    if (parameters[0] < 0 || parameters[1] < 1 || parameters[2] < 1 ||
+    fclose(fp);
+    return check_parameter_values(parameters);
+}
+
+/* Checks that parameters have valid values, returning an error code if any
+do not. */
+int check_parameter_values(float *parameters)
+{
+    if (parameters[0] < -1 || parameters[1] < 1 || parameters[2] < 1 ||
         parameters[3] < 0 || parameters[4] < 0 || parameters[5] < 0 ||
         parameters[6] < 0 || parameters[7] < 0)
     {
-        fprintf(stderr, "You have input an invalid parameter value! "
-                        "\nmaxQueueLength, averageCustomersPerMinute, "
-                        "meanMinsPerCustomerTask, "
-                        "standardDeviationMinsPerCustomerTask, "
-                        "meanMaxQueueTimePerCustomer, and "
-                        "standardDeviationMaxQueueTimePerCustomer must be at "
-                        "least 0.\nnumServicePoints and closingTime must be "
-                        "at least 1.");
-        exit(EXIT_FAILURE);
+        return SIMQ_ERROR_PARAMETERS;
     }
 
-    fclose(fp);
-    return parameters;
+    return SIMQ_OK;
 }
 
-/* Outputs list of parameter values read from the input file. */
-void output_parameters(char *results_file, int max_queue_length,
-                       int num_service_points, int closing_time,
-                       float avg_customer_rate, float mean_mins,
-                       float std_dev_mins, float mean_tolerance,
-                       float std_dev_tolerance)
+/* Opens the results file once for all of the output, writing through a
+large buffer which is flushed after the given number of interval records,
+or only when it is full if that is 0. Records are only written for every
+given number of time slices, and only to the binary trace if one is given
+for a summary only. Returns an error code if a file cannot be opened. */
+int open_output(OUTPUT *output, char *results_file, char *trace_file,
+                int record_interval, int flush_interval, int summary_only)
 {
-    FILE *fp;
+    output->fp = NULL;
+    output->trace_fp = NULL;
+    output->buffer = NULL;
+    output->trace_buffer = NULL;
+    output->record_interval = record_interval;
+    output->flush_interval = flush_interval;
+    output->summary_only = summary_only;
+    output->num_unflushed_records = 0;
+    output->show_arrival_rate = 0;
+
+    int error = open_buffered_file(results_file, &output->fp,
+                                   &output->buffer);
+    if (error == SIMQ_OK && trace_file != NULL)
+    {
+        error = open_buffered_file(trace_file, &output->trace_fp,
+                                   &output->trace_buffer);
+    }
+
+    return error;
+}
+
+/* Opens a file to write to through a newly allocated buffer, returning an
+error code if it cannot be opened or there is not enough memory. */
+int open_buffered_file(char *file_name, FILE **fp, char **buffer)
+{
+    if ((*fp = fopen(file_name, "w")) == NULL)
+    {
+        return SIMQ_ERROR_FILE;
+    }
+
+    if (!(*buffer = (char *)malloc(OUTPUT_BUFFER_SIZE)))
+    {
+        fclose(*fp);
+        *fp = NULL;
+        return SIMQ_ERROR_MEMORY;
+    }
+    setvbuf(*fp, *buffer, _IOFBF, OUTPUT_BUFFER_SIZE);
+
+    return SIMQ_OK;
+}
 
-    /* Error handling for opening the file in append mode. */
-    if ((fp = fopen(results_file, "w")) == NULL)
+/* Writes out anything left in the buffers and closes the files, returning
+an error code if anything could not be written. */
+int close_output(OUTPUT *output)
+{
+    int error = SIMQ_OK;
+    if ((output->fp != NULL && fclose(output->fp) != 0) ||
+        (output->trace_fp != NULL && fclose(output->trace_fp) != 0))
     {
-        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
-        exit(1);
+        error = SIMQ_ERROR_FILE;
     }
+    free(output->buffer);
+    free(output->trace_buffer);
 
-    fprintf(fp, "Parameters Read From Input File:\n   Max Queue Length: "
-                "%d\n   Number of Service Points: %d\n   Closing Time: %d\n"
-                "   Average Customers Per Interval: %f\n   Mean of Task "
-                "Length: %f\n   Standard Deviation of Task Length: %f\n   "
-                "Mean of Customer Tolerance: %f\n   Standard Deviation of "
-                "Customer Tolerance: %f\n\n",
+    return error;
+}
+
+/* Checks if records for each time interval are written anywhere. */
+int wants_interval_records(OUTPUT *output)
+{
+    return !output->summary_only || output->trace_fp != NULL;
+}
+
+/* Outputs list of parameter values read from the input file, returning an
+error code if the header of the binary trace cannot be written. */
+int output_parameters(OUTPUT *output, int max_queue_length,
+                      int num_service_points, int closing_time,
+                      float avg_customer_rate, float mean_mins,
+                      float std_dev_mins, float mean_tolerance,
+                      float std_dev_tolerance)
+{
+    fprintf(output->fp, "Parameters Read From Input File:\n   Max Queue "
+                        "Length: %d\n   Number of Service Points: %d\n   "
+                        "Closing Time: %d\n   Average Customers Per "
+                        "Interval: %f\n   Mean of Task Length: %f\n   "
+                        "Standard Deviation of Task Length: %f\n   Mean of "
+                        "Customer Tolerance: %f\n   Standard Deviation of "
+                        "Customer Tolerance: %f\n\n",
             max_queue_length, num_service_points, closing_time,
             avg_customer_rate, mean_mins, std_dev_mins, mean_tolerance,
             std_dev_tolerance);
 
-    fclose(fp);
+    if (output->trace_fp != NULL)
+    {
+        return write_trace_header(output->trace_fp, max_queue_length,
+                                  num_service_points, closing_time,
+                                  avg_customer_rate, mean_mins, std_dev_mins,
+                                  mean_tolerance, std_dev_tolerance);
+    }
+
+    return SIMQ_OK;
 }
 
-/* Outputs live information about the simulation for a given time interval. */
-void output_interval_record(char *results_file, int time_slice,
-                            int closing_time, int num_being_served,
-                            int queue_length, int num_fulfilled,
-                            int num_unfulfilled, int num_timed_out)
+/* Outputs live information about the simulation for a given time interval,
+if it is one of the intervals to have a record. The time slice at closing
+time always has one. The number of customers arriving per interval is only
+shown once an arrival schedule has been output. Returns an error code if
+the record cannot be written, which for the results file is only found once
+its buffer is flushed. */
+int output_interval_record(OUTPUT *output, int time_slice,
+                           int closing_time, int num_being_served,
+                           int queue_length, int num_fulfilled,
+                           int num_unfulfilled, int num_timed_out,
+                           float arrival_rate)
 {
-    FILE *fp;
+    if (time_slice % output->record_interval != 0 &&
+        time_slice != closing_time)
+    {
+        return SIMQ_OK;
+    }
 
-    /* Error handling for opening the file in append mode. */
-    if ((fp = fopen(results_file, "a")) == NULL)
+    if (output->trace_fp != NULL &&
+        write_trace_record(output->trace_fp, time_slice, num_being_served,
+                           queue_length, num_fulfilled, num_unfulfilled,
+                           num_timed_out) != SIMQ_OK)
     {
-        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
-        exit(1);
+        return SIMQ_ERROR_FILE;
     }
 
-    fprintf(fp, "Time Slice: %d\n   Number of Customers Currently Being "
-                "Served: %d\n   Number of People Currently in the Queue: "
-                "%d\n   Number of Fulfilled Customers: %d\n   Number of "
-                "Unfulfilled Customers: %d\n   Number of Timed Out "
-                "Customers: %d\n\n",
-            time_slice, num_being_served, queue_length,
-            num_fulfilled, num_unfulfilled, num_timed_out);
+    /* Only the binary trace has records for a summary only. */
+    if (!output->summary_only)
+    {
+        fprintf(output->fp, "Time Slice: %d\n", time_slice);
+        if (output->show_arrival_rate)
+        {
+            fprintf(output->fp, "   Customers Arriving Per Interval: %f\n",
+                    arrival_rate);
+        }
+        fprintf(output->fp, "   Number of Customers Currently Being Served: "
+                            "%d\n   Number of People Currently in the "
+                            "Queue: %d\n   Number of Fulfilled Customers: "
+                            "%d\n   Number of Unfulfilled Customers: %d\n   "
+                            "Number of Timed Out Customers: %d\n\n",
+                num_being_served, queue_length, num_fulfilled,
+                num_unfulfilled, num_timed_out);
 
-    if (time_slice == closing_time)
+        if (time_slice == closing_time)
+        {
+            fprintf(output->fp, "Closing time has been reached!\n\n");
+        }
+    }
+
+    /* Flushes the buffers once enough records have built up in them. */
+    output->num_unflushed_records++;
+    if (output->flush_interval > 0 &&
+        output->num_unflushed_records == output->flush_interval)
     {
-        fprintf(fp, "Closing time has been reached!\n\n");
+        output->num_unflushed_records = 0;
+        if (fflush(output->fp) != 0 ||
+            (output->trace_fp != NULL && fflush(output->trace_fp) != 0))
+        {
+            return SIMQ_ERROR_FILE;
+        }
     }
 
-    fclose(fp);
+    return ferror(output->fp) ? SIMQ_ERROR_FILE : SIMQ_OK;
 }
 
-/* Outputs statistics about averages in a file for a single simulation. */
-void output_results_sing(char *results_file, int time_after_closing,
-                         int num_fulfilled, int fulfilled_wait_time)
+/* Outputs the values of a class of customer added to the input file after
+the main parameters. */
+void output_class_parameters(OUTPUT *output, char *name,
+                             float avg_customer_rate, int mean_mins,
+                             int std_dev_mins, int mean_tolerance,
+                             int std_dev_tolerance, int priority)
 {
-    FILE *fp;
+    fprintf(output->fp, "Customer Class %s:\n   Average Customers Per "
+                        "Interval: %f\n   Mean of Task Length: %d\n   "
+                        "Standard Deviation of Task Length: %d\n   Mean of "
+                        "Customer Tolerance: %d\n   Standard Deviation of "
+                        "Customer Tolerance: %d\n   Priority: %d\n\n",
+            name, avg_customer_rate, mean_mins, std_dev_mins, mean_tolerance,
+            std_dev_tolerance, priority);
+}
+
+/* Outputs the segments of the arrival schedule added to the input file, with
+the minute each starts and the multiple of the average rates customers
+arrive at, and shows the number of customers arriving in every record from
+then on. */
+void output_arrival_schedule(OUTPUT *output, int num_segments, int *starts,
+                             float *multiples)
+{
+    int segment;
+    fprintf(output->fp, "Arrival Schedule:\n");
+    for (segment = 0; segment < num_segments; segment++)
+    {
+        fprintf(output->fp, "   From Minute %d: %f Times Average Rate\n",
+                starts[segment], multiples[segment]);
+    }
+    fprintf(output->fp, "\n");
+    output->show_arrival_rate = 1;
+}
 
-    /* Error handling for opening the file in append mode. */
-    if ((fp = fopen(results_file, "a")) == NULL)
+/* Outputs the seed of the random numbers of the simulations, and the number
+of the simulation if only one of them was run. */
+void output_seed(OUTPUT *output, unsigned long seed, int replication)
+{
+    fprintf(output->fp, "Random Number Seed: %lu\n", seed);
+    if (replication >= 0)
     {
-        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
-        exit(1);
+        fprintf(output->fp, "Simulation Run Alone: %d\n", replication);
     }
+    fprintf(output->fp, "\n");
+}
+
+/* Outputs the averages of a day at the branch estimated from queueing
+theory, which treats the task lengths and tolerances as exponential, along
+with the chances for an average customer. */
+void output_estimate(OUTPUT *output, double num_fulfilled,
+                     double num_unfulfilled, double num_timed_out,
+                     double mean_wait, double time_after_closing,
+                     double blocking, double waiting, double abandonment,
+                     double utilisation)
+{
+    fprintf(output->fp, "Estimates From Queueing Theory:\n   Average Number "
+                        "of Customers Fulfilled: %f\n   Average Number of "
+                        "Customers Unfulfilled: %f\n   Average Number of "
+                        "Customers Timed Out: %f\n   Average Waiting Time "
+                        "of Fulfilled Customers: %f\n   Average Time After "
+                        "Closing to Finish Serving Remaining Customers: "
+                        "%f\n   Chance of the Queue Being Full: %f\n   "
+                        "Chance of Waiting: %f\n   Chance of Timing Out: "
+                        "%f\n   Utilisation of Service Points: %f\n\n",
+            num_fulfilled, num_unfulfilled, num_timed_out, mean_wait,
+            time_after_closing, blocking, waiting, abandonment, utilisation);
+}
 
-    fprintf(fp, "Time After Closing to Finish Serving Remaining Customers: "
-                "%d\nAverage Waiting Time of Fulfilled Customers: %f\n",
+/* Outputs statistics about averages in a file for a single simulation. */
+void output_results_sing(OUTPUT *output, long time_after_closing,
+                         long num_fulfilled, double fulfilled_wait_time)
+{
+    fprintf(output->fp, "Time After Closing to Finish Serving Remaining "
+                        "Customers: %ld\nAverage Waiting Time of Fulfilled "
+                        "Customers: %f\n",
             time_after_closing,
             (float)fulfilled_wait_time / num_fulfilled);
+}
 
-    fclose(fp);
+/* Outputs statistics about averages in a file for multiple simulations,
+along with the spread of the waiting times of fulfilled customers. The
+standard error and confidence interval are of the average waiting time of
+each simulation, and the percentiles are of the waiting time of each
+customer. */
+void output_results_mult(OUTPUT *output, int num_simulations,
+                         long num_customers, long num_fulfilled,
+                         double fulfilled_wait_time, long num_unfulfilled,
+                         long num_timed_out, long time_after_closing,
+                         double wait_std_dev, double wait_std_error,
+                         double wait_half_width, double wait_p50,
+                         double wait_p90, double wait_p99)
+{
+    fprintf(output->fp, "Average Number of Customers Fulfilled: %f\n"
+                        "Average Number of Customers Unfulfilled: %f\n"
+                        "Average Number of Customers Timed Out: %f\n"
+                        "Average Waiting Time of Fulfilled Customers: %f\n"
+                        "Average Time After Closing to Finish Serving "
+                        "Remaining Customers: %f\n"
+                        "Standard Deviation of Waiting Time of Fulfilled "
+                        "Customers: %f\n"
+                        "Standard Error of Average Waiting Time of Fulfilled "
+                        "Customers: %f\n"
+                        "Confidence Interval Half-Width of Average Waiting "
+                        "Time of Fulfilled Customers: %f\n"
+                        "Median Waiting Time of Fulfilled Customers: %f\n"
+                        "90th Percentile Waiting Time of Fulfilled "
+                        "Customers: %f\n"
+                        "99th Percentile Waiting Time of Fulfilled "
+                        "Customers: %f",
+            (float)num_fulfilled / num_simulations,
+            (float)num_unfulfilled / num_simulations,
+            (float)num_timed_out / num_simulations,
+            (float)fulfilled_wait_time / num_fulfilled,
+            (float)time_after_closing / num_simulations, wait_std_dev,
+            wait_std_error, wait_half_width, wait_p50, wait_p90, wait_p99);
 }
 
-/* Outputs statistics about averages in a file for multiple simulations. */
-void output_results_mult(char *results_file, int num_simulations,
-                         int num_customers, int num_fulfilled,
-                         int fulfilled_wait_time, int num_unfulfilled,
-                         int num_timed_out, int time_after_closing)
+/* Outputs statistics about averages for a single class of customer, over
+however many simulations were performed. */
+void output_class_results(OUTPUT *output, char *name, int num_simulations,
+                          long num_customers, long num_fulfilled,
+                          double fulfilled_wait_time, long num_unfulfilled,
+                          long num_timed_out)
 {
-    FILE *fp;
+    fprintf(output->fp, "\nCustomer Class %s:\n"
+                        "   Average Number of Customers: %f\n"
+                        "   Average Number of Customers Fulfilled: %f\n"
+                        "   Average Number of Customers Unfulfilled: %f\n"
+                        "   Average Number of Customers Timed Out: %f\n"
+                        "   Average Waiting Time of Fulfilled Customers: %f",
+            name, (float)num_customers / num_simulations,
+            (float)num_fulfilled / num_simulations,
+            (float)num_unfulfilled / num_simulations,
+            (float)num_timed_out / num_simulations,
+            num_fulfilled > 0 ? (float)fulfilled_wait_time / num_fulfilled
+                              : 0);
+}
+
+/* Outputs how much antithetic pairs reduced the variance of the average
+waiting time, as the number of independent simulations which would be
+needed for the same confidence interval. */
+void output_variance_reduction(OUTPUT *output, int num_simulations,
+                               long num_pairs, double variance_reduction)
+{
+    fprintf(output->fp, "\nNumber of Antithetic Pairs: %ld\n"
+                        "Variance Reduction Factor of Average Waiting Time: "
+                        "%f\nEquivalent Number of Independent Simulations: "
+                        "%f",
+            num_pairs, variance_reduction,
+            variance_reduction * num_simulations);
+}
+
+/* Outputs how many simulations were run to reach the precision, and the
+half-widths of the confidence intervals they stopped at. That of the
+average waiting time is already given with the other averages. */
+void output_confidence_intervals(OUTPUT *output, int num_simulations,
+                                 int precision_reached,
+                                 double unfulfilled_width,
+                                 double timed_out_width)
+{
+    fprintf(output->fp, "\nNumber of Simulations Performed: %d\n"
+                        "Precision Reached: %s\n"
+                        "Confidence Interval Half-Width of Average Number of "
+                        "Customers Unfulfilled: %f\n"
+                        "Confidence Interval Half-Width of Average Number of "
+                        "Customers Timed Out: %f",
+            num_simulations, precision_reached ? "Yes" : "No",
+            unfulfilled_width, timed_out_width);
+}
+
+/* Outputs the names of the columns of the table of results for a sweep. */
+void output_sweep_header(OUTPUT *output)
+{
+    fprintf(output->fp, "maxQueueLength,numServicePoints,closingTime,"
+                        "averageCustomersPerMinute,meanMinsPerCustomerTask,"
+                        "standardDeviationMinsPerCustomerTask,"
+                        "meanMaxQueueTimePerCustomer,"
+                        "standardDeviationMaxQueueTimePerCustomer,"
+                        "averageFulfilled,averageUnfulfilled,"
+                        "averageTimedOut,averageWaitingTimeOfFulfilled,"
+                        "averageTimeAfterClosing\n");
+}
 
-    /* Error handling for opening the file in write mode. */
-    if ((fp = fopen(results_file, "a")) == NULL)
+/* Outputs a row of the table of results for a sweep, with the parameters
+of the scenario followed by the same averages as for multiple
+simulations. */
+void output_sweep_row(OUTPUT *output, int max_queue_length,
+                      int num_service_points, int closing_time,
+                      float avg_customer_rate, float mean_mins,
+                      float std_dev_mins, float mean_tolerance,
+                      float std_dev_tolerance, int num_simulations,
+                      long num_fulfilled, double fulfilled_wait_time,
+                      long num_unfulfilled, long num_timed_out,
+                      long time_after_closing)
+{
+    fprintf(output->fp, "%d,%d,%d,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f\n",
+            max_queue_length, num_service_points, closing_time,
+            avg_customer_rate, mean_mins, std_dev_mins, mean_tolerance,
+            std_dev_tolerance, (float)num_fulfilled / num_simulations,
+            (float)num_unfulfilled / num_simulations,
+            (float)num_timed_out / num_simulations,
+            (float)fulfilled_wait_time / num_fulfilled,
+            (float)time_after_closing / num_simulations);
+}
+
+/* Outputs a row of the table of results for a sweep with the averages
+estimated from queueing theory in place of those of simulations. */
+void output_sweep_estimate_row(OUTPUT *output, float *parameters,
+                               double num_fulfilled, double num_unfulfilled,
+                               double num_timed_out, double mean_wait,
+                               double time_after_closing)
+{
+    fprintf(output->fp, "%d,%d,%d,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f\n",
+            (int)parameters[0], (int)parameters[1], (int)parameters[2],
+            parameters[3], parameters[4], parameters[5], parameters[6],
+            parameters[7], num_fulfilled, num_unfulfilled, num_timed_out,
+            mean_wait, time_after_closing);
+}
+
+/* Outputs the names of the columns of the table of the fewest service points
+meeting the targets. */
+void output_staffing_header(OUTPUT *output)
+{
+    fprintf(output->fp, "maxQueueLength,numServicePoints,servicePointsTried,"
+                        "simulationsRun,averageFulfilled,averageUnfulfilled,"
+                        "averageTimedOut,averageWaitingTimeOfFulfilled,"
+                        "averageTimeAfterClosing\n");
+}
+
+/* Outputs a row of the table of the fewest service points meeting the
+targets for a maximum queue length, with how many numbers of service points
+and simulations in all were tried to find them, followed by the averages of
+the simulations of the number found. The number and averages are left empty
+if no number in the range meets the targets. */
+void output_staffing_row(OUTPUT *output, int max_queue_length,
+                         int num_service_points, int num_tried,
+                         int num_simulations_run, int num_simulations,
+                         long num_fulfilled, double fulfilled_wait_time,
+                         long num_unfulfilled, long num_timed_out,
+                         long time_after_closing)
+{
+    if (num_service_points == 0)
     {
-        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
-        exit(1);
+        fprintf(output->fp, "%d,,%d,%d,,,,,\n", max_queue_length, num_tried,
+                num_simulations_run);
+        return;
     }
 
-    fprintf(fp, "Average Number of Customers Fulfilled: %f\n"
-                "Average Number of Customers Unfulfilled: %f\n"
-                "Average Number of Customers Timed Out: %f\n"
-                "Average Waiting Time of Fulfilled Customers: %f\n"
-                "Average Time After Closing to Finish Serving Remaining "
-                "Customers: %f",
+    fprintf(output->fp, "%d,%d,%d,%d,%f,%f,%f,%f,%f\n", max_queue_length,
+            num_service_points, num_tried, num_simulations_run,
             (float)num_fulfilled / num_simulations,
             (float)num_unfulfilled / num_simulations,
             (float)num_timed_out / num_simulations,
             (float)fulfilled_wait_time / num_fulfilled,
             (float)time_after_closing / num_simulations);
+}
 
-    fclose(fp);
+/* Outputs the names of the columns of the table of results for a network,
+which are those of a sweep after the name of the branch. */
+void output_network_header(OUTPUT *output)
+{
+    fprintf(output->fp, "branch,");
+    output_sweep_header(output);
+}
+
+/* Outputs a row of the table of results for a network, with the name of the
+branch followed by its parameters and averages as for a sweep. */
+void output_network_row(OUTPUT *output, char *name, float *parameters,
+                        int num_simulations, long num_fulfilled,
+                        double fulfilled_wait_time, long num_unfulfilled,
+                        long num_timed_out, long time_after_closing)
+{
+    fprintf(output->fp, "%s,", name);
+    output_sweep_row(output, parameters[0], parameters[1], parameters[2],
+                     parameters[3], parameters[4], parameters[5],
+                     parameters[6], parameters[7], num_simulations,
+                     num_fulfilled, fulfilled_wait_time, num_unfulfilled,
+                     num_timed_out, time_after_closing);
+}
+
+/* Outputs the row of the table of results for the whole region of a
+network, which has no parameters. The numbers of customers are the totals
+over every branch in an average simulation, the waiting time is the average
+over every fulfilled customer in the region, and the time after closing is
+the average over the branches. */
+void output_network_region(OUTPUT *output, int num_branches,
+                           int num_simulations, long num_fulfilled,
+                           double fulfilled_wait_time, long num_unfulfilled,
+                           long num_timed_out, long time_after_closing)
+{
+    fprintf(output->fp, "region,,,,,,,,,%f,%f,%f,%f,%f\n",
+            (float)num_fulfilled / num_simulations,
+            (float)num_unfulfilled / num_simulations,
+            (float)num_timed_out / num_simulations,
+            (float)fulfilled_wait_time / num_fulfilled,
+            (float)time_after_closing / num_simulations / num_branches);
+}
+
+/* Outputs the answer to a request to the server, with its identifier
+followed by the same averages as a row of the table for a sweep, separated
+by spaces. */
+void output_server_results(FILE *fp, char *id, int num_simulations,
+                           long num_fulfilled, double fulfilled_wait_time,
+                           long num_unfulfilled, long num_timed_out,
+                           long time_after_closing)
+{
+    fprintf(fp, "%s ok %f %f %f %f %f\n", id,
+            (float)num_fulfilled / num_simulations,
+            (float)num_unfulfilled / num_simulations,
+            (float)num_timed_out / num_simulations,
+            (float)fulfilled_wait_time / num_fulfilled,
+            (float)time_after_closing / num_simulations);
+}
+
+/* Outputs the reason a request to the server could not be answered, after
+its identifier. */
+void output_server_error(FILE *fp, char *id, const char *message)
+{
+    fprintf(fp, "%s error %s\n", id, message);
+}
+
+/* Outputs the number of heap allocations made for the state of the
+simulations, which should all happen during the first simulation on each
+thread. */
+void output_allocation_stats(int num_simulations, int num_threads,
+                             long num_heap_allocations,
+                             long num_later_heap_allocations)
+{
+    fprintf(stderr, "Heap Allocations for Simulation State: %ld over %d "
+                    "simulations on %d threads\n"
+                    "Heap Allocations After the First Simulation on Each "
+                    "Thread: %ld\n",
+            num_heap_allocations, num_simulations, num_threads,
+            num_later_heap_allocations);
 }
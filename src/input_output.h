@@ -7,12 +7,67 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <errors.h>
+#include <trace.h>
+
+/* Number of parameters read from the input file. */
+#define NUM_PARAMETERS 8
+
+/* Size in bytes of the buffer the results file is written through. */
+#define OUTPUT_BUFFER_SIZE 1048576
+
+/* Output structure for the results file and the binary trace, if there is
+one, which stay open for the whole run, and whether the records show the
+number of customers arriving. */
+struct output
+{
+    FILE *fp, *trace_fp;
+    char *buffer, *trace_buffer;
+    int record_interval, flush_interval, summary_only, num_unflushed_records;
+    int show_arrival_rate;
+};
+typedef struct output OUTPUT;
+
 /* Input output function prototypes. */
-float *read_parameter_file(char *);
-void output_parameters(char *, int, int, int, float, float, float, float,
-                       float);
-void output_interval_record(char *, int, int, int, int, int, int, int);
-void output_results_sing(char *, int, int, int);
-void output_results_mult(char *, int, int, int, int, int, int, int);
+int read_parameter_file(char *, float *);
+int check_parameter_values(float *);
+int open_output(OUTPUT *, char *, char *, int, int, int);
+int open_buffered_file(char *, FILE **, char **);
+int close_output(OUTPUT *);
+int wants_interval_records(OUTPUT *);
+int output_parameters(OUTPUT *, int, int, int, float, float, float, float,
+                      float);
+int output_interval_record(OUTPUT *, int, int, int, int, int, int, int,
+                           float);
+void output_arrival_schedule(OUTPUT *, int, int *, float *);
+void output_seed(OUTPUT *, unsigned long, int);
+void output_class_parameters(OUTPUT *, char *, float, int, int, int, int,
+                             int);
+void output_estimate(OUTPUT *, double, double, double, double, double,
+                     double, double, double, double);
+void output_results_sing(OUTPUT *, long, long, double);
+void output_results_mult(OUTPUT *, int, long, long, double, long, long, long,
+                         double, double, double, double, double, double);
+void output_class_results(OUTPUT *, char *, int, long, long, double, long,
+                          long);
+void output_variance_reduction(OUTPUT *, int, long, double);
+void output_confidence_intervals(OUTPUT *, int, int, double, double);
+void output_sweep_header(OUTPUT *);
+void output_sweep_row(OUTPUT *, int, int, int, float, float, float, float,
+                      float, int, long, double, long, long, long);
+void output_sweep_estimate_row(OUTPUT *, float *, double, double, double,
+                               double, double);
+void output_staffing_header(OUTPUT *);
+void output_staffing_row(OUTPUT *, int, int, int, int, int, long, double,
+                         long, long, long);
+void output_network_header(OUTPUT *);
+void output_network_row(OUTPUT *, char *, float *, int, long, double, long,
+                        long, long);
+void output_network_region(OUTPUT *, int, int, long, double, long, long,
+                           long);
+void output_server_results(FILE *, char *, int, long, double, long, long,
+                           long);
+void output_server_error(FILE *, char *, const char *);
+void output_allocation_stats(int, int, long, long);
 
 #endif
@@ -0,0 +1,427 @@
+/* Runs simulations of a Post Office branch within another program, through
+simulation contexts which each hold all of the state of their
+simulations. */
+#include <libsimq_private.h>
+
+/* Simulation context structure holding the parameters, random number
+generators, service points and arena of its simulations, the state of the
+simulation in progress, its results and the totals of those which have
+finished. It is only used through the functions of the library, so its
+fields can change without changing any program which uses it. */
+struct simq
+{
+    PARAMETERS params;
+    int event_driven, max_service_points, running, simulation, after_first;
+    float resolution;
+    STREAMS streams;
+    SERVICE_POINTS *service_points;
+    ARENA *arena;
+    SIMULATION tick;
+    EVENT_SIMULATION event;
+    RESULTS current, totals;
+};
+
+/* Messages describing each error code. */
+static const char *error_messages[NUM_SIMQ_ERRORS] = {
+    "No error", "Not enough memory", "A file could not be opened or written",
+    "A parameter has an invalid value", "A class of customer is invalid",
+    "The simulation has already finished",
+    "The arrival schedule is invalid"};
+
+/* Mixes the bits of a number so that nearby numbers give unrelated ones,
+using the finalizer of SplitMix64. */
+uint64_t mix_seed_bits(uint64_t bits)
+{
+    bits = (bits ^ (bits >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    bits = (bits ^ (bits >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return bits ^ (bits >> 31);
+}
+
+/* Finds the seed of a stream of the simulation with the given number, from
+the seed of the run alone, so any simulation can be run again on its
+own. */
+unsigned long find_stream_seed(unsigned long seed, long simulation,
+                               int stream)
+{
+    uint64_t bits = mix_seed_bits((uint64_t)seed +
+                                  SEED_INCREMENT * ((uint64_t)simulation + 1));
+    return mix_seed_bits(bits + SEED_INCREMENT * ((uint64_t)stream + 1));
+}
+
+/* Finds a seed for the part of a run with the given number, such as a
+scenario or branch, from the seed of the run alone. It is that of a stream
+past the last of the simulation with the same number, so it is unrelated to
+the random numbers of any simulation of the run. */
+unsigned long simq_derive_seed(unsigned long seed, long number)
+{
+    return find_stream_seed(seed, number, NUM_STREAMS);
+}
+
+/* Creates the random number generators for a context, which are seeded for
+each simulation from the given seed, along with the ones for antithetic
+pairs if they are wanted. Returns an error code if there is not enough
+memory for them. */
+int create_streams(STREAMS *streams, unsigned long seed, int antithetic)
+{
+    int stream;
+    for (stream = 0; stream < NUM_STREAMS; stream++)
+    {
+        streams->r[stream] = NULL;
+        streams->saved_r[stream] = NULL;
+        streams->antithetic_r[stream] = NULL;
+    }
+    streams->seed = seed;
+    streams->antithetic = antithetic;
+    streams->last_simulation = -1;
+    streams->first_wait = 0;
+
+    for (stream = 0; stream < NUM_STREAMS; stream++)
+    {
+        if (!(streams->r[stream] = gsl_rng_alloc(gsl_rng_default)))
+        {
+            free_streams(streams);
+            return SIMQ_ERROR_MEMORY;
+        }
+        if (antithetic)
+        {
+            streams->saved_r[stream] = gsl_rng_clone(streams->r[stream]);
+            if (!streams->saved_r[stream] ||
+                !(streams->antithetic_r[stream] =
+                  create_antithetic_rng(streams->saved_r[stream])))
+            {
+                free_streams(streams);
+                return SIMQ_ERROR_MEMORY;
+            }
+        }
+    }
+
+    return SIMQ_OK;
+}
+
+/* Seeds the random number generators of a context for the simulation with
+the given number, saving their state for the second of an antithetic
+pair. */
+void seed_streams(STREAMS *streams, int simulation)
+{
+    int stream;
+    for (stream = 0; stream < NUM_STREAMS; stream++)
+    {
+        gsl_rng_set(streams->r[stream],
+                    find_stream_seed(streams->seed, simulation, stream));
+        if (streams->antithetic)
+        {
+            gsl_rng_memcpy(streams->saved_r[stream], streams->r[stream]);
+        }
+    }
+}
+
+/* Frees the random number generators of a context which have been
+created. */
+void free_streams(STREAMS *streams)
+{
+    int stream;
+    for (stream = 0; stream < NUM_STREAMS; stream++)
+    {
+        if (streams->antithetic_r[stream] != NULL)
+        {
+            gsl_rng_free(streams->antithetic_r[stream]);
+        }
+        if (streams->saved_r[stream] != NULL)
+        {
+            gsl_rng_free(streams->saved_r[stream]);
+        }
+        if (streams->r[stream] != NULL)
+        {
+            gsl_rng_free(streams->r[stream]);
+        }
+    }
+}
+
+/* Gives the message describing an error code. */
+const char *simq_error_message(int error)
+{
+    if (error < 0 || error >= NUM_SIMQ_ERRORS)
+    {
+        return "Unknown error";
+    }
+
+    return error_messages[error];
+}
+
+/* Reads the parameters, classes of customer and arrival schedule of a
+simulation from an input file, along with the values of the parameters as
+they are in the file unless they are not wanted. Returns an error code if
+the file cannot be opened or anything in it is invalid. */
+int simq_read_parameters(char *input_parameters, float *values,
+                         PARAMETERS *params)
+{
+    float file_values[NUM_PARAMETERS];
+    if (values == NULL)
+    {
+        values = file_values;
+    }
+
+    int error = read_parameter_file(input_parameters, values);
+    if (error != SIMQ_OK)
+    {
+        return error;
+    }
+
+    set_parameters(params, values);
+    error = read_customer_classes(input_parameters, params->classes,
+                                  &params->num_classes);
+    if (error != SIMQ_OK)
+    {
+        return error;
+    }
+
+    return read_arrival_schedule(input_parameters, &params->schedule);
+}
+
+/* Creates a simulation context for the given parameters, taking the engine,
+resolution, antithetic pairs and seed from the configuration, with no
+simulations run yet. Returns an error code if there is not enough memory,
+leaving the context NULL. */
+int simq_init(SIMQ **context, PARAMETERS *params, SIMQ_CONFIG *config)
+{
+    SIMQ *simq = NULL;
+    *context = NULL;
+
+    if (!(simq = (SIMQ *)malloc(sizeof(SIMQ))))
+    {
+        return SIMQ_ERROR_MEMORY;
+    }
+    if (create_streams(&simq->streams, config->seed, config->antithetic) !=
+        SIMQ_OK)
+    {
+        free(simq);
+        return SIMQ_ERROR_MEMORY;
+    }
+    if (!(simq->service_points = create_service_points(
+              params->num_service_points)))
+    {
+        free_streams(&simq->streams);
+        free(simq);
+        return SIMQ_ERROR_MEMORY;
+    }
+    if (!(simq->arena = create_arena(ARENA_SIZE)))
+    {
+        free_service_points(simq->service_points);
+        free_streams(&simq->streams);
+        free(simq);
+        return SIMQ_ERROR_MEMORY;
+    }
+
+    simq->params = *params;
+    simq->event_driven = config->event_driven;
+    simq->resolution = config->resolution;
+    simq->max_service_points = params->num_service_points;
+    simq->running = 0;
+    simq->simulation = -1;
+    simq->after_first = 0;
+    create_empty_results(&simq->current);
+    create_empty_results(&simq->totals);
+
+    *context = simq;
+    return SIMQ_OK;
+}
+
+/* Changes the parameters and seed of the next simulations of a context,
+such as for another scenario or branch, keeping the totals so far. The
+service points are only created again if there are more of them. Returns an
+error code if there is not enough memory for them. */
+int simq_set_parameters(SIMQ *simq, PARAMETERS *params, unsigned long seed)
+{
+    if (params->num_service_points > simq->max_service_points)
+    {
+        SERVICE_POINTS *service_points = create_service_points(
+            params->num_service_points);
+        if (service_points == NULL)
+        {
+            return SIMQ_ERROR_MEMORY;
+        }
+        free_service_points(simq->service_points);
+        simq->service_points = service_points;
+        simq->max_service_points = params->num_service_points;
+    }
+
+    simq->params = *params;
+    simq->streams.seed = seed;
+    simq->streams.last_simulation = -1;
+    simq->running = 0;
+
+    return SIMQ_OK;
+}
+
+/* Starts the simulation with the given number, after making all of the
+memory in the arena and every service point available again. Its random
+numbers depend only on its number and the seed of the context. With
+antithetic pairs, every odd simulation is given the antithetic of each
+uniform number given to the one before it. A record is output for each time
+interval if an output is given. Returns an error code if there is not enough
+memory. */
+int simq_start(SIMQ *simq, int simulation, OUTPUT *output)
+{
+    STREAMS *streams = &simq->streams;
+    gsl_rng **r = streams->r;
+    int second_of_pair = streams->antithetic && simulation % 2 == 1;
+    simq->after_first = second_of_pair &&
+                        streams->last_simulation == simulation - 1;
+    if (second_of_pair)
+    {
+        if (!simq->after_first)
+        {
+            seed_streams(streams, simulation - 1);
+        }
+        r = streams->antithetic_r;
+    }
+    else
+    {
+        seed_streams(streams, simulation);
+    }
+
+    simq->simulation = simulation;
+    create_empty_results(&simq->current);
+    reset_arena(simq->arena);
+    reset_service_points(simq->service_points,
+                         simq->params.num_service_points);
+
+    int error;
+    if (simq->event_driven)
+    {
+        error = start_event_simulation(&simq->event, &simq->params,
+                                       simq->resolution, simq->arena,
+                                       r[ARRIVAL_STREAM], r[CUSTOMER_STREAM],
+                                       &simq->current, output);
+    }
+    else
+    {
+        error = start_simulation(&simq->tick, &simq->params,
+                                 simq->service_points, simq->arena,
+                                 r[ARRIVAL_STREAM], r[CUSTOMER_STREAM],
+                                 &simq->current, output);
+    }
+    simq->running = error == SIMQ_OK;
+
+    return error;
+}
+
+/* Simulates the next time slice, or the next event with the event engine,
+of the simulation in progress, which is finished once the last customer has
+left. Returns an error code if there is not enough memory or no simulation
+is in progress, which also finishes it without adding onto the totals. */
+int simq_step(SIMQ *simq, int *finished)
+{
+    *finished = 1;
+    if (!simq->running)
+    {
+        return SIMQ_ERROR_FINISHED;
+    }
+
+    int error, closed;
+    if (simq->event_driven)
+    {
+        error = step_event_simulation(&simq->event);
+        closed = simq->event.closed;
+    }
+    else
+    {
+        error = step_simulation(&simq->tick);
+        closed = simq->tick.closed;
+    }
+
+    if (error != SIMQ_OK)
+    {
+        simq->running = 0;
+        return error;
+    }
+    if (closed)
+    {
+        simq_finish(simq);
+    }
+    *finished = closed;
+
+    return SIMQ_OK;
+}
+
+/* Adds the results of the simulation which has just finished onto the
+totals along with its average waiting time, and the average waiting time of
+the pair if it is the second of an antithetic pair whose first has just
+been run. */
+void simq_finish(SIMQ *simq)
+{
+    RESULTS *current = &simq->current;
+    STREAMS *streams = &simq->streams;
+
+    double wait = find_average_wait(current);
+    add_running_value(&current->simulation_fulfilled,
+                      current->num_fulfilled);
+    add_running_value(&current->simulation_unfulfilled,
+                      current->num_unfulfilled);
+    add_running_value(&current->simulation_timed_out,
+                      current->num_timed_out);
+    add_running_value(&current->simulation_wait, wait);
+    if (simq->after_first)
+    {
+        add_running_value(&current->pair_wait,
+                          (streams->first_wait + wait) / 2);
+    }
+    streams->first_wait = wait;
+    streams->last_simulation = simq->simulation;
+
+    merge_results(&simq->totals, current);
+    simq->running = 0;
+}
+
+/* Runs the simulation with the given number from start to finish, adding
+its results onto the totals. Returns an error code if there is not enough
+memory. */
+int simq_run(SIMQ *simq, int simulation, OUTPUT *output)
+{
+    int finished = 0;
+    int error = simq_start(simq, simulation, output);
+
+    while (error == SIMQ_OK && !finished)
+    {
+        error = simq_step(simq, &finished);
+    }
+
+    return error;
+}
+
+/* Gives the totals of the simulations which have finished, along with the
+results so far of the one in progress. */
+void simq_results(SIMQ *simq, RESULTS *results)
+{
+    *results = simq->totals;
+    if (simq->running)
+    {
+        merge_results(results, &simq->current);
+    }
+}
+
+/* Sets the totals back to zero, such as once they have been taken. */
+void simq_clear_results(SIMQ *simq)
+{
+    create_empty_results(&simq->totals);
+}
+
+/* Gives the number of heap allocations the arena of a context has made. */
+long simq_heap_allocations(SIMQ *simq)
+{
+    return simq->arena->num_heap_allocations;
+}
+
+/* Frees the memory used by a context and everything in it. */
+void simq_destroy(SIMQ *simq)
+{
+    if (simq == NULL)
+    {
+        return;
+    }
+
+    free_arena(simq->arena);
+    free_service_points(simq->service_points);
+    free_streams(&simq->streams);
+    free(simq);
+}
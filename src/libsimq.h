@@ -0,0 +1,47 @@
+/* Header file for the simulation library, which runs simulations of a Post
+Office branch within another program. Each simulation context holds all of
+the state of its simulations, so any number of them can run at once on
+different threads, and errors are returned as error codes instead of
+exiting. */
+#ifndef __LIBSIMQ_H
+#define __LIBSIMQ_H
+
+#include <errors.h>
+
+/* Parameters, results and output of simulations, whose fields are in
+simulation.h and input_output.h for programs which use them. */
+struct parameters;
+struct results;
+struct output;
+
+/* Configuration structure holding how the simulations of a context are run,
+which is with the event engine at the given resolution instead of the tick
+engine if asked for, in antithetic pairs if asked for, and from the seed of
+the run. */
+struct simq_config
+{
+    int event_driven, antithetic;
+    float resolution;
+    unsigned long seed;
+};
+typedef struct simq_config SIMQ_CONFIG;
+
+/* Simulation context, whose fields are only used within the library. */
+typedef struct simq SIMQ;
+
+/* Simulation library function prototypes. */
+const char *simq_error_message(int);
+unsigned long simq_derive_seed(unsigned long, long);
+int simq_read_parameters(char *, float *, struct parameters *);
+int simq_init(SIMQ **, struct parameters *, SIMQ_CONFIG *);
+int simq_set_parameters(SIMQ *, struct parameters *, unsigned long);
+int simq_start(SIMQ *, int, struct output *);
+int simq_step(SIMQ *, int *);
+void simq_finish(SIMQ *);
+int simq_run(SIMQ *, int, struct output *);
+void simq_results(SIMQ *, struct results *);
+void simq_clear_results(SIMQ *);
+long simq_heap_allocations(SIMQ *);
+void simq_destroy(SIMQ *);
+
+#endif
@@ -0,0 +1,57 @@
+/* Private header file for the simulation library, holding the random number
+streams of each context and everything else its functions use which
+programs using the library do not need. */
+#ifndef __LIBSIMQ_PRIVATE_H
+#define __LIBSIMQ_PRIVATE_H
+
+#include <errno.h>
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_randist.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <arena.h>
+#include <customer.h>
+#include <errors.h>
+#include <input_output.h>
+#include <libsimq.h>
+#include <random_numbers.h>
+#include <service_points.h>
+#include <simulation.h>
+
+/* Number of random number generators each context has, with one for the
+arrivals and one for the customers who arrive, so that each pair of
+antithetic simulations stays in step for longer. */
+#define NUM_STREAMS 2
+#define ARRIVAL_STREAM 0
+#define CUSTOMER_STREAM 1
+
+/* Odd constant added onto the seed for each simulation and stream before
+its bits are mixed, which is 2^64 divided by the golden ratio. */
+#define SEED_INCREMENT UINT64_C(0x9e3779b97f4a7c15)
+
+/* Streams structure holding the random number generators of a context,
+which are seeded afresh for each simulation from the seed of the run and the
+number of the simulation. For antithetic pairs, the state of the generators
+is saved when they are seeded for the first simulation of each pair, and the
+antithetic generators read from the saved state for the second. */
+struct streams
+{
+    gsl_rng *r[NUM_STREAMS], *saved_r[NUM_STREAMS],
+        *antithetic_r[NUM_STREAMS];
+    unsigned long seed;
+    int antithetic, last_simulation;
+    double first_wait;
+};
+typedef struct streams STREAMS;
+
+/* Private simulation library function prototypes. */
+uint64_t mix_seed_bits(uint64_t);
+unsigned long find_stream_seed(unsigned long, long, int);
+int create_streams(STREAMS *, unsigned long, int);
+void seed_streams(STREAMS *, int);
+void free_streams(STREAMS *);
+
+#endif
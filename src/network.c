@@ -0,0 +1,228 @@
+/* Simulates a network of branches in a region, each with its own input file,
+in one run. */
+#include <network.h>
+
+/* Reads the input file of every branch in a directory, skipping hidden
+files. The branches are sorted by the names of their files, so that they
+are always in the same order. */
+void read_network_directory(char *network_directory, NETWORK *network)
+{
+    DIR *dir;
+    struct dirent *entry;
+    int max_branches = 16;
+
+    /* Opens the directory to read the names of the files from it. */
+    if ((dir = opendir(network_directory)) == NULL)
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    network->num_branches = 0;
+    if (!(network->branches = (BRANCH *)malloc(max_branches *
+                                               sizeof(BRANCH))))
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        /* Doubles the space for branches if it is full. */
+        if (network->num_branches == max_branches)
+        {
+            max_branches *= 2;
+            if (!(network->branches = (BRANCH *)realloc(
+                      network->branches, max_branches * sizeof(BRANCH))))
+            {
+                fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        BRANCH *branch = &network->branches[network->num_branches++];
+        if (!(branch->name = (char *)malloc(strlen(entry->d_name) + 1)))
+        {
+            fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+        strcpy(branch->name, entry->d_name);
+    }
+
+    closedir(dir);
+
+    if (network->num_branches == 0)
+    {
+        fprintf(stderr, "The network directory must have an input file for "
+                        "at least one branch!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    qsort(network->branches, network->num_branches, sizeof(BRANCH),
+          compare_branch_names);
+
+    /* Reads the parameters of each branch from its file. */
+    int branch;
+    for (branch = 0; branch < network->num_branches; branch++)
+    {
+        BRANCH *current = &network->branches[branch];
+        char *path = NULL;
+        if (!(path = (char *)malloc(strlen(network_directory) +
+                                    strlen(current->name) + 2)))
+        {
+            fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+        sprintf(path, "%s/%s", network_directory, current->name);
+
+        exit_on_error(simq_read_parameters(path, current->parameters,
+                                           &current->params));
+        create_empty_results(&current->results);
+        free(path);
+    }
+}
+
+/* Compares two branches by their names, for sorting. */
+int compare_branch_names(const void *first, const void *second)
+{
+    return strcmp(((BRANCH *)first)->name, ((BRANCH *)second)->name);
+}
+
+/* Frees the memory used by the branches of the network. */
+void free_network(NETWORK *network)
+{
+    int branch;
+    for (branch = 0; branch < network->num_branches; branch++)
+    {
+        free(network->branches[branch].name);
+    }
+    free(network->branches);
+}
+
+/* Runs the simulations for one branch after another, reusing the same
+simulation context for all of them. The random numbers of each branch are
+seeded from the seed of the branch, so its results do not depend on which
+thread simulated it. */
+void *run_network_worker(void *arg)
+{
+    NETWORK_WORKER *worker = (NETWORK_WORKER *)arg;
+    NETWORK *network = worker->network;
+
+    SIMQ *simq;
+    SIMQ_CONFIG config;
+    set_simq_config(&config, worker->options);
+    exit_on_error(simq_init(&simq, &network->branches[0].params, &config));
+
+    while (1)
+    {
+        /* Takes the next branch no other thread has taken. */
+        pthread_mutex_lock(worker->lock);
+        int next = (*worker->next_branch)++;
+        pthread_mutex_unlock(worker->lock);
+        if (next >= network->num_branches)
+        {
+            break;
+        }
+
+        BRANCH *branch = &network->branches[next];
+        exit_on_error(simq_set_parameters(simq, &branch->params,
+                                          branch->seed));
+
+        int simulation;
+        for (simulation = 0; simulation < worker->options->num_simulations;
+             simulation++)
+        {
+            exit_on_error(simq_run(simq, simulation, NULL));
+        }
+        simq_results(simq, &branch->results);
+        simq_clear_results(simq);
+    }
+
+    simq_destroy(simq);
+    return NULL;
+}
+
+/* Simulates every branch in the network, sharing them out between the
+threads as they become free, and outputs a table with a row of results for
+each branch followed by a row for the whole region. */
+void run_network(NETWORK *network, OPTIONS *options, OUTPUT *output)
+{
+    int num_threads = options->num_threads;
+    if (num_threads > network->num_branches)
+    {
+        num_threads = network->num_branches;
+    }
+
+    NETWORK_WORKER *workers = NULL;
+    if (!(workers = (NETWORK_WORKER *)malloc(num_threads *
+                                             sizeof(NETWORK_WORKER))))
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    /* Seeds every branch from the seed of the run and its number, so its
+    results do not depend on which thread simulated it or on the type of
+    generator. */
+    int branch;
+    for (branch = 0; branch < network->num_branches; branch++)
+    {
+        network->branches[branch].seed =
+            simq_derive_seed(options->seed, branch);
+    }
+
+    int next_branch = 0;
+    pthread_mutex_t lock;
+    pthread_mutex_init(&lock, NULL);
+
+    int thread;
+    for (thread = 0; thread < num_threads; thread++)
+    {
+        workers[thread].network = network;
+        workers[thread].options = options;
+        workers[thread].next_branch = &next_branch;
+        workers[thread].lock = &lock;
+
+        int error = pthread_create(&workers[thread].thread, NULL,
+                                   run_network_worker, &workers[thread]);
+        if (error != 0)
+        {
+            fprintf(stderr, "Error %d: %s\n", error, strerror(error));
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (thread = 0; thread < num_threads; thread++)
+    {
+        pthread_join(workers[thread].thread, NULL);
+    }
+    pthread_mutex_destroy(&lock);
+
+    /* Outputs the results in the same order as the branches, adding each
+    onto the totals for the region. */
+    RESULTS region;
+    create_empty_results(&region);
+    output_network_header(output);
+    for (branch = 0; branch < network->num_branches; branch++)
+    {
+        BRANCH *current = &network->branches[branch];
+        output_network_row(output, current->name, current->parameters,
+                           options->num_simulations,
+                           current->results.num_fulfilled,
+                           current->results.fulfilled_wait_time,
+                           current->results.num_unfulfilled,
+                           current->results.num_timed_out,
+                           current->results.time_after_closing);
+        merge_results(&region, &current->results);
+    }
+    output_network_region(output, network->num_branches,
+                          options->num_simulations, region.num_fulfilled,
+                          region.fulfilled_wait_time, region.num_unfulfilled,
+                          region.num_timed_out, region.time_after_closing);
+
+    free(workers);
+}
@@ -0,0 +1,67 @@
+/* Header file for simulating a network of branches in a region, each with
+its own input file, in one run. */
+#ifndef __NETWORK_H
+#define __NETWORK_H
+
+#include <dirent.h>
+#include <errno.h>
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_randist.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <arena.h>
+#include <cli.h>
+#include <input_output.h>
+#include <options.h>
+#include <replications.h>
+#include <service_points.h>
+#include <libsimq.h>
+#include <simulation.h>
+
+/* Branch structure holding the state of a single branch, with its name,
+the parameters from its input file, the seed of its own random number
+generators and its running totals. */
+struct branch
+{
+    char *name;
+    float parameters[NUM_PARAMETERS];
+    PARAMETERS params;
+    unsigned long seed;
+    RESULTS results;
+};
+typedef struct branch BRANCH;
+
+/* Network structure holding every branch in the region, in order of the
+names of their input files. */
+struct network
+{
+    BRANCH *branches;
+    int num_branches;
+};
+typedef struct network NETWORK;
+
+/* Network worker structure holding the state owned by a single thread,
+which takes the next branch from those shared between the threads until
+there are none left. */
+struct network_worker
+{
+    NETWORK *network;
+    OPTIONS *options;
+    int *next_branch;
+    pthread_mutex_t *lock;
+    pthread_t thread;
+};
+typedef struct network_worker NETWORK_WORKER;
+
+/* Network function prototypes. */
+void read_network_directory(char *, NETWORK *);
+int compare_branch_names(const void *, const void *);
+void free_network(NETWORK *);
+void *run_network_worker(void *);
+void run_network(NETWORK *, OPTIONS *, OUTPUT *);
+
+#endif
@@ -0,0 +1,348 @@
+/* Reads the command line options of the simulation. */
+#include <options.h>
+
+/* Reads the required and optional parameters passed into the program. */
+void read_options(int argc, char **argv, OPTIONS *options)
+{
+    /* Serving requests needs no input file, number of simulations or
+    output file, so the options start straight after --serve. */
+    int first_option = 4;
+    options->serve = argc >= 2 && strcmp(argv[1], "--serve") == 0;
+    if (options->serve)
+    {
+        first_option = 2;
+        options->input_parameters = NULL;
+        options->num_simulations = 0;
+        options->results_file = NULL;
+    }
+    else
+    {
+        /* Checks that enough parameters have been passed into the
+        program. */
+        if (argc < 4)
+        {
+            fprintf(stderr, "Not enough parameters passed in! You must "
+                            "provide the input file, number of simulations, "
+                            "and output file.");
+            exit(EXIT_FAILURE);
+        }
+
+        /* Checks that the second parameter input by the user is a
+        digit. */
+        if (!isdigit(*argv[2]))
+        {
+            fprintf(stderr, "You have not input a digit for the number of "
+                            "simulations!");
+            exit(EXIT_FAILURE);
+        }
+
+        /* Takes the configuration from the parameters. */
+        options->input_parameters = argv[1];
+        options->num_simulations = atoi(argv[2]);
+        options->results_file = argv[3];
+    }
+
+    /* Default values for the optional parameters. */
+    options->num_threads = 1;
+    options->event_driven = 0;
+    options->resolution = 1;
+    options->alloc_stats = 0;
+    options->record_interval = 1;
+    options->flush_interval = 0;
+    options->summary_only = 0;
+    options->trace_file = NULL;
+    options->sweep_file = NULL;
+    options->staffing_file = NULL;
+    options->antithetic = 0;
+    options->network = 0;
+    options->precision = 0;
+    options->checkpoint_file = NULL;
+    options->checkpoint_interval = DEFAULT_CHECKPOINT_INTERVAL;
+    options->resume = 0;
+    options->replication = -1;
+    options->socket_file = NULL;
+    options->analytic = 0;
+    options->analytic_only = 0;
+
+    /* Seeds from the time and the process, so runs started in the same
+    second still differ, unless a seed is given. */
+    options->seed = (unsigned long)time(0) ^
+                    ((unsigned long)getpid() << 16);
+    options->seeded = 0;
+
+    /* Reads the optional parameters given after the required ones. */
+    int arg;
+    for (arg = first_option; arg < argc; arg++)
+    {
+        if (strcmp(argv[arg], "--threads") == 0 && arg + 1 < argc)
+        {
+            options->num_threads = read_positive_option(argv[arg],
+                                                        argv[arg + 1]);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--engine") == 0 && arg + 1 < argc)
+        {
+            if (strcmp(argv[arg + 1], "event") == 0)
+            {
+                options->event_driven = 1;
+            }
+            else if (strcmp(argv[arg + 1], "tick") == 0)
+            {
+                options->event_driven = 0;
+            }
+            else
+            {
+                fprintf(stderr, "The engine must be either tick or event!\n");
+                exit(EXIT_FAILURE);
+            }
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--resolution") == 0 && arg + 1 < argc)
+        {
+            options->resolution = read_fraction_option(argv[arg],
+                                                       argv[arg + 1]);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--output-every") == 0 && arg + 1 < argc)
+        {
+            options->record_interval = read_positive_option(argv[arg],
+                                                            argv[arg + 1]);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--flush-every") == 0 && arg + 1 < argc)
+        {
+            options->flush_interval = read_count_option(argv[arg],
+                                                        argv[arg + 1]);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--summary-only") == 0)
+        {
+            options->summary_only = 1;
+        }
+        else if (strcmp(argv[arg], "--trace") == 0 && arg + 1 < argc)
+        {
+            options->trace_file = argv[arg + 1];
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--sweep") == 0 && arg + 1 < argc)
+        {
+            options->sweep_file = argv[arg + 1];
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--staff") == 0 && arg + 1 < argc)
+        {
+            options->staffing_file = argv[arg + 1];
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--precision") == 0 && arg + 1 < argc)
+        {
+            options->precision = read_fraction_option(argv[arg],
+                                                      argv[arg + 1]);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--antithetic") == 0)
+        {
+            options->antithetic = 1;
+        }
+        else if (strcmp(argv[arg], "--network") == 0)
+        {
+            options->network = 1;
+        }
+        else if (strcmp(argv[arg], "--checkpoint") == 0 && arg + 1 < argc)
+        {
+            options->checkpoint_file = argv[arg + 1];
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--checkpoint-every") == 0 &&
+                 arg + 1 < argc)
+        {
+            options->checkpoint_interval = read_positive_option(
+                argv[arg], argv[arg + 1]);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--resume") == 0)
+        {
+            options->resume = 1;
+        }
+        else if (strcmp(argv[arg], "--seed") == 0 && arg + 1 < argc)
+        {
+            options->seed = read_seed_option(argv[arg], argv[arg + 1]);
+            options->seeded = 1;
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--replication") == 0 && arg + 1 < argc)
+        {
+            options->replication = read_count_option(argv[arg],
+                                                     argv[arg + 1]);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--socket") == 0 && arg + 1 < argc)
+        {
+            options->socket_file = argv[arg + 1];
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--analytic") == 0)
+        {
+            options->analytic = 1;
+        }
+        else if (strcmp(argv[arg], "--analytic-only") == 0)
+        {
+            options->analytic_only = 1;
+        }
+        else if (strcmp(argv[arg], "--alloc-stats") == 0)
+        {
+            options->alloc_stats = 1;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option or missing value: %s\n",
+                    argv[arg]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /* Checks a checkpoint is only asked for where it can be used. */
+    if (options->resume && options->checkpoint_file == NULL)
+    {
+        fprintf(stderr, "You must give the checkpoint file to resume from "
+                        "with --checkpoint!\n");
+        exit(EXIT_FAILURE);
+    }
+    if ((options->checkpoint_file != NULL || options->replication >= 0) &&
+        (options->sweep_file != NULL || options->network))
+    {
+        fprintf(stderr, "Checkpoints and single replications cannot be used "
+                        "with --sweep or --network!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (options->socket_file != NULL && !options->serve)
+    {
+        fprintf(stderr, "A socket can only be given with --serve!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (options->serve &&
+        (options->sweep_file != NULL || options->network ||
+         options->checkpoint_file != NULL || options->replication >= 0 ||
+         options->trace_file != NULL || options->precision > 0 ||
+         options->alloc_stats || options->analytic ||
+         options->analytic_only || options->staffing_file != NULL))
+    {
+        fprintf(stderr, "Sweeps, networks, checkpoints, single "
+                        "replications, traces, precisions, allocation "
+                        "statistics, estimates and staffing searches cannot "
+                        "be used with --serve!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Checks a search for the fewest service points runs on its own, as it
+    decides how many simulations to run itself. */
+    if (options->staffing_file != NULL &&
+        (options->sweep_file != NULL || options->network ||
+         options->checkpoint_file != NULL || options->replication >= 0 ||
+         options->trace_file != NULL || options->precision > 0 ||
+         options->analytic || options->analytic_only))
+    {
+        fprintf(stderr, "Sweeps, networks, checkpoints, single "
+                        "replications, traces, precisions and estimates "
+                        "cannot be used with --staff!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Checks a search has simulations to judge the targets by, as with
+    none every target would count as met. */
+    if (options->staffing_file != NULL && options->num_simulations < 1)
+    {
+        fprintf(stderr, "At least one simulation must be run with "
+                        "--staff!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Checks estimates from queueing theory are only asked for where they
+    can be given, which for a sweep is only in place of simulating. */
+    if ((options->analytic || options->analytic_only) && options->network)
+    {
+        fprintf(stderr, "Estimates cannot be used with --network!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (options->analytic && options->sweep_file != NULL)
+    {
+        fprintf(stderr, "Only --analytic-only can be used with --sweep!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (options->analytic_only &&
+        (options->checkpoint_file != NULL || options->replication >= 0 ||
+         options->trace_file != NULL || options->precision > 0))
+    {
+        fprintf(stderr, "Checkpoints, single replications, traces and "
+                        "precisions cannot be used with --analytic-only!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Reads the value of an option which must be a number of at least 1. */
+int read_positive_option(char *name, char *value)
+{
+    if (!isdigit(*value) || atoi(value) < 1)
+    {
+        fprintf(stderr, "You must input a number of at least 1 for %s!\n",
+                name);
+        exit(EXIT_FAILURE);
+    }
+
+    return atoi(value);
+}
+
+/* Reads the value of an option which must be a number of at least 0. */
+int read_count_option(char *name, char *value)
+{
+    if (!isdigit(*value))
+    {
+        fprintf(stderr, "You must input a number of at least 0 for %s!\n",
+                name);
+        exit(EXIT_FAILURE);
+    }
+
+    return atoi(value);
+}
+
+/* Reads the value of an option which must be a number from 0 to 1. */
+float read_fraction_option(char *name, char *value)
+{
+    char *end;
+    float fraction = strtod(value, &end);
+    if (end == value || *end != '\0' || fraction < 0 || fraction > 1)
+    {
+        fprintf(stderr, "You must input a number from 0 to 1 for %s!\n",
+                name);
+        exit(EXIT_FAILURE);
+    }
+
+    return fraction;
+}
+
+/* Reads the value of an option which must be a whole number of at least 0
+which fits in an unsigned long. */
+unsigned long read_seed_option(char *name, char *value)
+{
+    char *end;
+    errno = 0;
+    unsigned long seed = strtoul(value, &end, 10);
+    if (!isdigit(*value) || *end != '\0' || errno == ERANGE)
+    {
+        fprintf(stderr, "You must input a whole number of at least 0 for "
+                        "%s!\n",
+                name);
+        exit(EXIT_FAILURE);
+    }
+
+    return seed;
+}
+
+/* Sets the configuration of a simulation context from the options. */
+void set_simq_config(SIMQ_CONFIG *config, OPTIONS *options)
+{
+    config->event_driven = options->event_driven;
+    config->antithetic = options->antithetic;
+    config->resolution = options->resolution;
+    config->seed = options->seed;
+}
@@ -0,0 +1,41 @@
+/* Header file for reading the command line options of the simulation. */
+#ifndef __OPTIONS_H
+#define __OPTIONS_H
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <libsimq.h>
+
+/* Number of simulations each thread runs between checkpoints, unless it is
+given with --checkpoint-every. */
+#define DEFAULT_CHECKPOINT_INTERVAL 100
+
+/* Options structure holding everything passed in on the command line. */
+struct options
+{
+    char *input_parameters, *results_file, *trace_file, *sweep_file,
+        *checkpoint_file, *socket_file, *staffing_file;
+    int num_simulations, num_threads, event_driven, alloc_stats;
+    int record_interval, flush_interval, summary_only, antithetic, network;
+    int checkpoint_interval, resume, seeded, replication, serve;
+    int analytic, analytic_only;
+    unsigned long seed;
+    float resolution, precision;
+};
+typedef struct options OPTIONS;
+
+/* Options function prototypes. */
+void read_options(int, char **, OPTIONS *);
+int read_positive_option(char *, char *);
+int read_count_option(char *, char *);
+float read_fraction_option(char *, char *);
+unsigned long read_seed_option(char *, char *);
+void set_simq_config(SIMQ_CONFIG *, OPTIONS *);
+
+#endif
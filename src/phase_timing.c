@@ -0,0 +1,117 @@
+/* Times each phase of the time-sliced simulation with the cycle counter of the
+processor. */
+#include <phase_timing.h>
+
+/* Names of the phases, in the order of their numbers. */
+static const char *phase_names[NUM_PHASES] = {
+    "Serving Customers", "Fulfilling Customers", "Leaving Early",
+    "Arrivals", "Interval Records"};
+
+/* Reads the cycle counter of the processor, or the processor time used where
+there is no counter which can be read directly. */
+uint64_t read_cycle_counter(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    uint32_t low, high;
+    __asm__ __volatile__("rdtsc" : "=a"(low), "=d"(high));
+    return ((uint64_t)high << 32) | low;
+#elif defined(__GNUC__) && defined(__aarch64__)
+    uint64_t count;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(count));
+    return count;
+#else
+    return clock();
+#endif
+}
+
+/* Creates timings with no cycles counted in any phase. */
+void create_phase_timings(PHASE_TIMINGS *timings)
+{
+    int phase;
+    for (phase = 0; phase < NUM_PHASES; phase++)
+    {
+        timings->cycles[phase] = 0;
+    }
+    timings->start = 0;
+    timings->num_time_slices = 0;
+}
+
+/* Adds the cycles since the last phase started onto the given phase, which
+the next phase then starts from. A time slice is counted after its last
+phase. */
+void end_phase(PHASE_TIMINGS *timings, int phase)
+{
+    uint64_t now = read_cycle_counter();
+    timings->cycles[phase] += now - timings->start;
+    timings->start = now;
+    if (phase == NUM_PHASES - 1)
+    {
+        timings->num_time_slices++;
+    }
+}
+
+/* Adds the cycles and time slices of one set of timings onto another. */
+void merge_phase_timings(PHASE_TIMINGS *total, PHASE_TIMINGS *timings)
+{
+    int phase;
+    for (phase = 0; phase < NUM_PHASES; phase++)
+    {
+        total->cycles[phase] += timings->cycles[phase];
+    }
+    total->num_time_slices += timings->num_time_slices;
+}
+
+/* Finds how many cycles the counter counts each second by counting them
+while waiting for a short length of processor time to pass. */
+double find_cycles_per_second(void)
+{
+    clock_t first = clock();
+    clock_t start;
+
+    /* Waits for the processor time to tick over first, so the length of
+    time waited is whole ticks. */
+    while ((start = clock()) == first)
+    {
+    }
+    uint64_t start_cycles = read_cycle_counter();
+
+    clock_t now;
+    while ((now = clock()) - start < CALIBRATION_SECONDS * CLOCKS_PER_SEC)
+    {
+    }
+
+    return (read_cycle_counter() - start_cycles) /
+           ((double)(now - start) / CLOCKS_PER_SEC);
+}
+
+/* Outputs the seconds and share of the cycles spent in each phase, and the
+number of time slices simulated each second, counting the time of every
+thread. */
+void output_phase_timings(PHASE_TIMINGS *timings)
+{
+    double cycles_per_second = find_cycles_per_second();
+    uint64_t total = 0;
+    int phase;
+    for (phase = 0; phase < NUM_PHASES; phase++)
+    {
+        total += timings->cycles[phase];
+    }
+
+    if (total == 0)
+    {
+        fprintf(stderr, "Phase Timings: no time slices of the tick engine "
+                        "were timed\n");
+        return;
+    }
+
+    fprintf(stderr, "Phase Timings over %ld Time Slices:\n",
+            timings->num_time_slices);
+    for (phase = 0; phase < NUM_PHASES; phase++)
+    {
+        fprintf(stderr, "%-24s%12.6f s %6.2f%%\n", phase_names[phase],
+                timings->cycles[phase] / cycles_per_second,
+                100.0 * timings->cycles[phase] / total);
+    }
+    fprintf(stderr, "Time Slices per Second: %f\n",
+            timings->num_time_slices / (total / cycles_per_second));
+}
@@ -0,0 +1,54 @@
+/* Header file for timing each phase of the time-sliced simulation with the
+cycle counter of the processor. The timing is only compiled in when
+PHASE_TIMING is defined, such as with CFLAGS=-DPHASE_TIMING. */
+#ifndef __PHASE_TIMING_H
+#define __PHASE_TIMING_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Phases of each time slice which are timed separately. */
+#define NUM_PHASES 5
+#define SERVE_PHASE 0
+#define FULFIL_PHASE 1
+#define LEAVE_PHASE 2
+#define ARRIVAL_PHASE 3
+#define OUTPUT_PHASE 4
+
+/* Length of processor time in seconds the cycle counter is compared to, to
+find how many cycles it counts each second. */
+#define CALIBRATION_SECONDS 0.05
+
+/* Phase timings structure holding the cycles counted in each phase and the
+number of time slices they were counted over. Each phase ends where the
+next one starts, so only one count is read between them. */
+struct phase_timings
+{
+    uint64_t cycles[NUM_PHASES];
+    uint64_t start;
+    long num_time_slices;
+};
+typedef struct phase_timings PHASE_TIMINGS;
+
+/* Starts timing the first phase of a time slice, and adds the cycles since
+the last phase started onto a phase, which leaves no cost when the timing is
+compiled out. */
+#ifdef PHASE_TIMING
+#define START_PHASES(timings) ((timings)->start = read_cycle_counter())
+#define END_PHASE(timings, phase) end_phase(timings, phase)
+#else
+#define START_PHASES(timings)
+#define END_PHASE(timings, phase)
+#endif
+
+/* Phase timing function prototypes. */
+uint64_t read_cycle_counter(void);
+void create_phase_timings(PHASE_TIMINGS *);
+void end_phase(PHASE_TIMINGS *, int);
+void merge_phase_timings(PHASE_TIMINGS *, PHASE_TIMINGS *);
+double find_cycles_per_second(void);
+void output_phase_timings(PHASE_TIMINGS *);
+
+#endif
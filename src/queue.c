@@ -1,19 +1,59 @@
-/* Handles the queue, which is implemented using linked lists. */
+/* Handles the queue, which is implemented as a ring buffer for each priority
+level holding each field of the customers in its own array. */
 #include <queue.h>
 
-/* Creates an empty queue for customers to join. */
-QUEUE *create_empty_queue(int max_queue_length)
+/* Creates an empty queue for customers to join, with a line for each
+priority level of the classes of customer, or returns NULL if there is not
+enough memory. */
+QUEUE *create_empty_queue(int max_queue_length, CUSTOMER_CLASS *classes,
+                          int num_classes, ARENA *arena)
 {
-    QUEUE *q = (QUEUE *)malloc(sizeof(QUEUE));
+    QUEUE *q = (QUEUE *)arena_allocate(arena, sizeof(QUEUE));
     if (q == NULL)
     {
-        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
-        exit(EXIT_FAILURE);
+        return NULL;
     }
 
-    q->front = q->rear = NULL;
+    q->arena = arena;
     q->queue_length = 0;
     q->max_queue_length = max_queue_length;
+    q->num_levels = find_priority_levels(classes, num_classes, q->levels);
+
+    int level;
+    for (level = 0; level < q->num_levels; level++)
+    {
+        PRIORITY_LINE *line = &q->lines[level];
+        line->mins = line->joined = line->waiting = line->classes = NULL;
+        line->first = line->next = 0;
+        line->length = 0;
+        line->max_customers = 0;
+        if (resize_line(q, line, 16) != SIMQ_OK)
+        {
+            return NULL;
+        }
+    }
+
+    /* Starts the timing wheel with every bucket empty. */
+    int bucket;
+    q->wheel.buckets = (int *)arena_allocate(arena,
+                                             NUM_WHEEL_BUCKETS * sizeof(int));
+    if (q->wheel.buckets == NULL)
+    {
+        return NULL;
+    }
+    for (bucket = 0; bucket < NUM_WHEEL_BUCKETS; bucket++)
+    {
+        q->wheel.buckets[bucket] = -1;
+    }
+    q->wheel.max_entries = 16;
+    q->wheel.num_entries = 0;
+    q->wheel.free_entry = -1;
+    q->wheel.entries = (WHEEL_ENTRY *)arena_allocate(
+        arena, q->wheel.max_entries * sizeof(WHEEL_ENTRY));
+    if (q->wheel.entries == NULL)
+    {
+        return NULL;
+    }
 
     return q;
 }
@@ -21,178 +61,276 @@ QUEUE *create_empty_queue(int max_queue_length)
 /* Checks if the queue is empty. */
 int is_queue_empty(QUEUE *q)
 {
-    return (q->rear == NULL);
+    return (q->queue_length == 0);
 }
 
-/* Increments the waiting times of all people in the queue. */
-void increment_waiting_times(QUEUE *q)
+/* Moves the customers of a line into new space for the given number of
+customers, keeping each one at the slot given by their number. The old
+space is given back when the arena is reset. The line is left as it was if
+there is not enough memory. */
+int resize_line(QUEUE *q, PRIORITY_LINE *line, int max_customers)
 {
-    /* Starts from the front of the queue. */
-    CUSTOMER *customer = q->front;
+    int *mins = (int *)arena_allocate(q->arena, max_customers * sizeof(int));
+    int *joined = (int *)arena_allocate(q->arena,
+                                        max_customers * sizeof(int));
+    int *waiting = (int *)arena_allocate(q->arena,
+                                         max_customers * sizeof(int));
+    int *classes = (int *)arena_allocate(q->arena,
+                                         max_customers * sizeof(int));
+    if (mins == NULL || joined == NULL || waiting == NULL || classes == NULL)
+    {
+        return SIMQ_ERROR_MEMORY;
+    }
 
-    /* Iterates to print the details of each customer in the queue. */
-    while (customer != NULL)
+    /* Copies the customers across from the front to the rear. */
+    int customer;
+    for (customer = line->first; customer < line->next; customer++)
     {
-        customer->time_waited++;
-        customer = customer->next;
+        int slot = customer & (line->max_customers - 1);
+        int new_slot = customer & (max_customers - 1);
+        mins[new_slot] = line->mins[slot];
+        joined[new_slot] = line->joined[slot];
+        waiting[new_slot] = line->waiting[slot];
+        classes[new_slot] = line->classes[slot];
     }
+
+    line->mins = mins;
+    line->joined = joined;
+    line->waiting = waiting;
+    line->classes = classes;
+    line->max_customers = max_customers;
+
+    return SIMQ_OK;
 }
 
-/* Adds a value onto the end of the queue and increases queue count. */
-void enqueue(QUEUE *q, int mean_mins, int std_dev_mins, int mean_tolerance,
-             int std_dev_tolerance, gsl_rng *r)
+/* Adds a customer of a priority level to the bucket of the timing wheel for
+their deadline, reusing a free entry if there is one. */
+int add_to_timing_wheel(QUEUE *q, int level, int customer, int deadline)
 {
-    /* Creates a new customer and its mins and next customer pointer. */
-    CUSTOMER *customer = create_new_customer(mean_mins, std_dev_mins,
-                                             mean_tolerance,
-                                             std_dev_tolerance, r);
+    TIMING_WHEEL *wheel = &q->wheel;
+    int entry = wheel->free_entry;
 
-    /* Points front and rear of the queue to the new customer if empty.
- *  *     Otherwise, points the previous rear of the customer to this customer, and
- *   *         sets the new customer as the rear. */
-    if (is_queue_empty(q))
+    if (entry != -1)
     {
-        q->front = q->rear = customer;
-        q->queue_length++;
-        return;
+        wheel->free_entry = wheel->entries[entry].next;
     }
     else
     {
-        q->rear->next = customer;
-        q->rear = customer;
-        q->queue_length++;
+        /* Doubles the space for entries if they are all in use. */
+        if (wheel->num_entries == wheel->max_entries)
+        {
+            WHEEL_ENTRY *entries = (WHEEL_ENTRY *)arena_allocate(
+                q->arena, 2 * wheel->max_entries * sizeof(WHEEL_ENTRY));
+            if (entries == NULL)
+            {
+                return SIMQ_ERROR_MEMORY;
+            }
+            memcpy(entries, wheel->entries,
+                   wheel->num_entries * sizeof(WHEEL_ENTRY));
+            wheel->entries = entries;
+            wheel->max_entries *= 2;
+        }
+        entry = wheel->num_entries++;
     }
+
+    int bucket = deadline & (NUM_WHEEL_BUCKETS - 1);
+    wheel->entries[entry].customer = customer;
+    wheel->entries[entry].level = level;
+    wheel->entries[entry].deadline = deadline;
+    wheel->entries[entry].next = wheel->buckets[bucket];
+    wheel->buckets[bucket] = entry;
+
+    return SIMQ_OK;
 }
 
-/* Removes a given value from the queue. */
-int dequeue(QUEUE *q)
+/* Adds a customer of the given class onto the end of the line for its
+priority level and increases queue count. The customer starts waiting from
+the next time slice, and is put on the timing wheel to leave once they have
+waited as long as they will tolerate. Returns an error code if there is not
+enough memory for them. */
+int enqueue(QUEUE *q, int time_slice, int customer_class,
+             VARIATE_GENERATOR *mins_generator,
+             VARIATE_GENERATOR *tolerance_generator)
 {
-    /* Returns 0 if the queue is empty; there is no request to be handled. */
-    if (is_queue_empty(q))
+    /* Creates a new customer with their mins and tolerance. */
+    CUSTOMER customer = create_new_customer(mins_generator,
+                                            tolerance_generator);
+    int level = q->levels[customer_class];
+    PRIORITY_LINE *line = &q->lines[level];
+
+    /* Doubles the space for customers if the line fills it. */
+    if (line->next - line->first == line->max_customers &&
+        resize_line(q, line, 2 * line->max_customers) != SIMQ_OK)
     {
-        return 0;
+        return SIMQ_ERROR_MEMORY;
     }
 
-    /* Gets the previous front of the queue. */
-    CUSTOMER *customer = q->front;
-
-    /* Stores the mins from the customer, and moves the next customer up. */
-    int mins = customer->mins;
-    q->front = q->front->next;
+    /* Stores the customer in the slot for their number. */
+    int number = line->next++;
+    int slot = number & (line->max_customers - 1);
+    line->mins[slot] = customer.mins;
+    line->joined[slot] = time_slice + 1;
+    line->waiting[slot] = 1;
+    line->classes[slot] = customer_class;
+    line->length++;
+    q->queue_length++;
 
-    /* If this makes the front empty, make the rear empty, as this means the
- *  *     queue is empty. */
-    if (q->front == NULL)
+    /* A customer with no tolerance never leaves early, as their time waited
+    is only compared to it after it has been incremented. */
+    if (customer.tolerance > 0)
     {
-        q->rear = NULL;
+        return add_to_timing_wheel(q, level, number,
+                                   time_slice + customer.tolerance);
     }
 
-    free(customer);
-    q->queue_length--;
-    return mins;
+    return SIMQ_OK;
 }
 
-/* Attempts to service the customer at the front of the queue. */
-int fulfil_customer(QUEUE *q, int num_service_points, int *service_points,
-                    int fulfilled_wait_time)
+/* Moves the front of a line past customers who have left early. */
+void skip_departed_customers(PRIORITY_LINE *line)
 {
-    /* Takes the customer from the front of the queue. */
-    CUSTOMER *customer = q->front;
+    while (line->first < line->next &&
+           !line->waiting[line->first & (line->max_customers - 1)])
+    {
+        line->first++;
+    }
+}
 
-    /* Finds the first service point which is available. */
-    int point;
-    for (point = 0; point < num_service_points; point++)
+/* Finds the line of the highest priority with anyone waiting, with its
+front moved past customers who have left early, or NULL if the queue is
+empty. */
+PRIORITY_LINE *find_front_line(QUEUE *q)
+{
+    int level;
+    for (level = 0; level < q->num_levels; level++)
     {
-        if (service_points[point] == 0)
+        if (q->lines[level].length > 0)
         {
-            service_points[point] = customer->mins;
-            fulfilled_wait_time += customer->time_waited;
-            dequeue(q);
-            return fulfilled_wait_time;
+            skip_departed_customers(&q->lines[level]);
+            return &q->lines[level];
         }
     }
 
-    /* All service points may be in use. */
-    return fulfilled_wait_time;
+    return NULL;
+}
+
+/* Removes the next customer to serve from the queue. */
+int dequeue(QUEUE *q)
+{
+    /* Returns 0 if the queue is empty; there is no request to be handled. */
+    PRIORITY_LINE *line = find_front_line(q);
+    if (line == NULL)
+    {
+        return 0;
+    }
+
+    /* Stores the mins from the customer, and moves the next customer up. */
+    int slot = line->first & (line->max_customers - 1);
+    int mins = line->mins[slot];
+    line->waiting[slot] = 0;
+    line->first++;
+    line->length--;
+    q->queue_length--;
+
+    return mins;
 }
 
-/* Processes customers being served for that time slice. */
-int serve_customers(int num_fulfilled, int num_service_points,
-                    int *service_points)
+/* Services the customer at the front of the queue of the highest priority
+with anyone waiting, if a service point is available, adding the time they
+have waited since the time slice they joined onto the total and the
+statistics of waiting times. At most one customer starts being served in
+each time slice. The totals of each class count customers as fulfilled once
+they start being served, which is the same by the end of the simulation. */
+double fulfil_customer(QUEUE *q, SERVICE_POINTS *service_points,
+                       double fulfilled_wait_time, SAMPLE_STATS *waits,
+                       CLASS_RESULTS *class_results, int time_slice)
 {
-    /* Iterates to check for service points which are being used. */
-    int point;
-    for (point = 0; point < num_service_points; point++)
+    /* Does nothing if the queue is empty or all service points are in
+    use. */
+    if (!is_queue_empty(q) && service_points->num_free > 0)
     {
-        if (service_points[point] != 0)
+        PRIORITY_LINE *line = find_front_line(q);
+        int slot = line->first & (line->max_customers - 1);
+        int wait = time_slice - line->joined[slot];
+        CLASS_RESULTS *totals = &class_results[line->classes[slot]];
+        fulfilled_wait_time += wait;
+        totals->fulfilled_wait_time += wait;
+        add_sample_value(waits, wait);
+
+        /* A task taking no time leaves the service point free. */
+        int mins = dequeue(q);
+        if (mins > 0)
         {
-            service_points[point]--;
-            /* Checks if a customer has been fully served. */
-            if (service_points[point] == 0)
-            {
-                num_fulfilled++;
-            }
+            start_service(service_points, time_slice, mins);
+            totals->num_fulfilled++;
         }
     }
 
-    return num_fulfilled;
+    return fulfilled_wait_time;
 }
 
-/* Removes people who have waited for too long from the queue. */
-int leave_queue_early(QUEUE *q, int num_timed_out)
+/* Processes customers being served for that time slice, freeing the service
+points whose customers have been fully served. */
+int serve_customers(int num_fulfilled, SERVICE_POINTS *service_points,
+                    int time_slice)
 {
-    /* Returns NULL if the queue is empty. */
-    if (is_queue_empty(q))
-    {
-        return num_timed_out;
-    }
+    return num_fulfilled + finish_services(service_points, time_slice);
+}
 
-    /* Starts from the front of the queue. */
-    CUSTOMER *customer = q->front;
+/* Removes people who have waited for too long from the queue. Only the
+customers in the bucket of the timing wheel for this time slice are
+checked, and those who have already been served are dropped from it. The
+time each waited before leaving is added onto their statistics, and each
+is counted in the totals of their class. */
+int leave_queue_early(QUEUE *q, int time_slice, int num_timed_out,
+                      RUNNING_STATS *timed_out_waits,
+                      CLASS_RESULTS *class_results)
+{
+    TIMING_WHEEL *wheel = &q->wheel;
+    int *link = &wheel->buckets[time_slice & (NUM_WHEEL_BUCKETS - 1)];
 
-    /* Iterates to check for customers in the queue who are leaving early. */
-    while (customer != NULL)
+    while (*link != -1)
     {
-        /* Checks if customer has waited for longer than they will tolerate. */
-        if (customer->time_waited == customer->tolerance)
-        {
-            /* Moves the next customer up. */
-            q->front = q->front->next;
+        int entry = *link;
+        WHEEL_ENTRY *wheel_entry = &wheel->entries[entry];
 
-            /* If this makes the front empty, make the rear empty, as this
- *  *             means the queue is empty. */
-            if (q->front == NULL)
-            {
-                q->rear = NULL;
-            }
+        /* Leaves customers due on a later turn of the wheel in place. */
+        if (wheel_entry->deadline != time_slice)
+        {
+            link = &wheel_entry->next;
+            continue;
+        }
 
-            num_timed_out++;
+        /* Checks the customer is still in the queue before removing them. */
+        PRIORITY_LINE *line = &q->lines[wheel_entry->level];
+        int customer = wheel_entry->customer;
+        int slot = customer & (line->max_customers - 1);
+        if (customer >= line->first && customer < line->next &&
+            line->waiting[slot])
+        {
+            line->waiting[slot] = 0;
+            line->length--;
             q->queue_length--;
+            num_timed_out++;
+            class_results[line->classes[slot]].num_timed_out++;
+            add_running_value(timed_out_waits,
+                              time_slice - line->joined[slot]);
+            skip_departed_customers(line);
         }
-        customer = customer->next;
+
+        /* Unlinks the entry and puts it on the list of free entries. */
+        *link = wheel_entry->next;
+        wheel_entry->next = wheel->free_entry;
+        wheel->free_entry = entry;
     }
 
-    free(customer);
     return num_timed_out;
 }
 
 /* Checks if it can close the entire branch so it can stop the simulation. */
-int is_branch_empty(QUEUE *q, int num_service_points, int *service_points)
+int is_branch_empty(QUEUE *q, SERVICE_POINTS *service_points)
 {
-    /* Queue must be empty for the branch to be empty. */
-    if (is_queue_empty)
-    {
-        /* Iterates to check that no service points are busy. */
-        int point;
-        for (point = 0; point < num_service_points; point++)
-        {
-            if (service_points[point] != 0)
-            {
-                return 0;
-            }
-        }
-
-        /* Branch is empty if the queue and all service points are empty. */
-        return 1;
-    }
+    /* Branch is empty if the queue and all service points are empty. */
+    return is_queue_empty(q) &&
+           count_busy_service_points(service_points) == 0;
 }
@@ -1,5 +1,6 @@
-/* Header file for handling the queue, which is implemented using linked
-lists. */
+/* Header file for handling the queue, which is implemented as a ring buffer
+for each priority level holding each field of the customers in its own
+array. */
 #ifndef __QUEUE_H
 #define __QUEUE_H
 
@@ -10,25 +11,76 @@ lists. */
 #include <stdlib.h>
 #include <string.h>
 
+#include <arena.h>
 #include <customer.h>
+#include <errors.h>
+#include <service_points.h>
+#include <stats.h>
 
-/* Queue structure in a linked list, with front and rear pointers. */
+/* Number of buckets in the timing wheel, which must be a power of two.
+Customers whose deadline is further away than this stay in their bucket
+until the wheel comes round to it again. */
+#define NUM_WHEEL_BUCKETS 256
+
+/* Wheel entry structure, for a customer of a priority level who will leave
+the queue at their deadline if they have not been served by then. */
+struct wheel_entry
+{
+    int customer, level, deadline, next;
+};
+typedef struct wheel_entry WHEEL_ENTRY;
+
+/* Timing wheel structure, where each bucket is a list of the entries whose
+deadline falls on a time slice equal to the bucket modulo the number of
+buckets. Entries are linked by their position, with -1 ending a list. */
+struct timing_wheel
+{
+    int *buckets;
+    WHEEL_ENTRY *entries;
+    int num_entries, max_entries, free_entry;
+};
+typedef struct timing_wheel TIMING_WHEEL;
+
+/* Priority line structure as a ring buffer, for the customers of the
+classes with the same priority. Each customer is given the next number of
+the line when they join, and is stored at number & (max_customers - 1), so
+they can be found from the timing wheel by their number. Customers who leave
+early are marked as no longer waiting and skipped once they reach the front.
+The space for customers is always a power of two, and is taken from the
+arena of the simulation. */
+struct priority_line
+{
+    int *mins, *joined, *waiting, *classes;
+    int first, next, length, max_customers;
+};
+typedef struct priority_line PRIORITY_LINE;
+
+/* Queue structure with a line for each priority level, from the highest
+priority first, so the next customer to serve is at the front of the first
+line with anyone waiting. */
 struct queue
 {
-    struct customer *front, *rear;
-    int queue_length, max_queue_length;
+    PRIORITY_LINE lines[MAX_CUSTOMER_CLASSES];
+    int levels[MAX_CUSTOMER_CLASSES];
+    int num_levels, queue_length, max_queue_length;
+    TIMING_WHEEL wheel;
+    ARENA *arena;
 };
 typedef struct queue QUEUE;
 
 /* Queue function prototypes. */
-QUEUE *create_empty_queue(int);
+QUEUE *create_empty_queue(int, CUSTOMER_CLASS *, int, ARENA *);
 int is_queue_empty(QUEUE *);
-void increment_waiting_times(QUEUE *);
-void enqueue(QUEUE *, int, int, int, int, gsl_rng *);
+int resize_line(QUEUE *, PRIORITY_LINE *, int);
+int add_to_timing_wheel(QUEUE *, int, int, int);
+int enqueue(QUEUE *, int, int, VARIATE_GENERATOR *, VARIATE_GENERATOR *);
+void skip_departed_customers(PRIORITY_LINE *);
+PRIORITY_LINE *find_front_line(QUEUE *);
 int dequeue(QUEUE *);
-int fulfil_customer(QUEUE *, int, int *, int);
-int serve_customers(int, int, int *);
-int leave_queue_early(QUEUE *, int);
-int is_branch_empty(QUEUE *, int, int *);
+double fulfil_customer(QUEUE *, SERVICE_POINTS *, double, SAMPLE_STATS *,
+                       CLASS_RESULTS *, int);
+int serve_customers(int, SERVICE_POINTS *, int);
+int leave_queue_early(QUEUE *, int, int, RUNNING_STATS *, CLASS_RESULTS *);
+int is_branch_empty(QUEUE *, SERVICE_POINTS *);
 
 #endif
@@ -1,27 +1,339 @@
 /* Generates random numbers using Poisson and Gaussian distributions. */
 #include <random_numbers.h>
 
-/* Generates a random numberator using Gaussian distribution. */
+/* Type of a random number generator which gives the antithetic of every
+uniform number from another generator. */
+static const gsl_rng_type antithetic_rng_type = {
+    "antithetic", 0xffffffffUL, 0, sizeof(ANTITHETIC_STATE),
+    set_antithetic_rng, get_antithetic_rng, get_antithetic_rng_double};
+
+/* Generates a random numberator using Poisson distribution. The number is
+found by inverting the distribution at a single uniform number, so that
+antithetic uniform numbers give negatively correlated numbers of
+customers. */
 int generate_random_poisson(float avg_customer_rate, gsl_rng *r)
 {
-    int random;
+    return invert_poisson(avg_customer_rate, gsl_rng_uniform_pos(r));
+}
+
+/* Generates a random numberator using Gaussian distribution, from a single
+uniform number. */
+int generate_random_gaussian(int mean, int std_dev, gsl_rng *r)
+{
+    return invert_gaussian(mean, std_dev, gsl_rng_uniform_pos(r));
+}
+
+/* Finds the number from the Poisson distribution at a uniform number by
+inverting the distribution, starting from the mean. */
+int invert_poisson(float avg_customer_rate, double u)
+{
+    if (avg_customer_rate <= 0)
+    {
+        return 0;
+    }
 
-    /* Creates a random number using the Poisson distribution based on
-    the rate parameter. */
-    random = gsl_ran_poisson(r, avg_customer_rate);
+    int random = floor(avg_customer_rate);
+    double probability = gsl_ran_poisson_pdf(random, avg_customer_rate);
+    double cumulative = gsl_cdf_poisson_P(random, avg_customer_rate);
+
+    /* Moves down while the number below still covers the uniform number,
+    or otherwise up until it is covered. */
+    if (u <= cumulative)
+    {
+        while (random > 0 && u <= cumulative - probability)
+        {
+            cumulative -= probability;
+            probability *= random / avg_customer_rate;
+            random--;
+        }
+    }
+    else
+    {
+        while (u > cumulative && probability > 0)
+        {
+            random++;
+            probability *= avg_customer_rate / random;
+            cumulative += probability;
+        }
+    }
 
     return random;
 }
 
-/* Generates a random numberator using Gaussian distribution. */
-int generate_random_gaussian(int mean, int std_dev, gsl_rng *r)
+/* Finds the number from the Gaussian distribution at a uniform number by
+inverting the distribution, with the uniform number scaled to leave out the
+numbers which would be below 0. */
+int invert_gaussian(int mean, int std_dev, double u)
 {
-    int random = -1;
+    if (std_dev <= 0)
+    {
+        return mean;
+    }
 
     /* Creates a random number >= 0 using the Gaussian distribution based on
     mean and standard deviation. */
-    while (random < 0)
-        random = gsl_ran_gaussian(r, std_dev) + mean;
+    double lowest = gsl_cdf_ugaussian_P((-1.0 - mean) / std_dev);
+    int random = std_dev * gsl_cdf_ugaussian_Pinv(lowest + u * (1 - lowest)) +
+                 mean;
+    if (random < 0)
+    {
+        random = 0;
+    }
 
     return random;
 }
+
+/* Creates a generator of numbers from the Poisson distribution, with a
+table covering the numbers around the mean, or returns NULL if there is not
+enough memory. */
+VARIATE_GENERATOR *create_poisson_generator(float avg_customer_rate,
+                                            gsl_rng *r, ARENA *arena)
+{
+    VARIATE_GENERATOR *generator = create_variate_generator(POISSON_VARIATE,
+                                                            r, arena);
+    if (generator == NULL)
+    {
+        return NULL;
+    }
+    generator->rate = avg_customer_rate;
+
+    /* Every number is 0 if no customers arrive. */
+    if (avg_customer_rate <= 0)
+    {
+        create_variate_table(generator, 0, 0, arena);
+        return generator;
+    }
+
+    double spread = VARIATE_TABLE_SPREAD * sqrt(avg_customer_rate);
+    double first = floor(avg_customer_rate - spread);
+    double last = ceil(avg_customer_rate + spread) + VARIATE_TABLE_SPREAD;
+    create_variate_table(generator, first < 0 ? 0 : first, last, arena);
+
+    return generator;
+}
+
+/* Creates a generator of numbers from the Gaussian distribution, with a
+table covering the numbers around the mean which are not below 0, or
+returns NULL if there is not enough memory. */
+VARIATE_GENERATOR *create_gaussian_generator(int mean, int std_dev,
+                                             gsl_rng *r, ARENA *arena)
+{
+    VARIATE_GENERATOR *generator = create_variate_generator(GAUSSIAN_VARIATE,
+                                                            r, arena);
+    if (generator == NULL)
+    {
+        return NULL;
+    }
+    generator->mean = mean;
+    generator->std_dev = std_dev;
+
+    /* Every number is the mean if there is no spread. */
+    if (std_dev <= 0)
+    {
+        create_variate_table(generator, mean, mean, arena);
+        return generator;
+    }
+
+    double spread = (double)VARIATE_TABLE_SPREAD * std_dev;
+    double first = floor(mean - spread);
+    double last = ceil(mean + spread);
+    create_variate_table(generator, first < 0 ? 0 : first, last, arena);
+
+    return generator;
+}
+
+/* Creates a generator of the given kind from the arena, which makes its
+first block of numbers once one is asked for, or returns NULL if there is not
+enough memory. */
+VARIATE_GENERATOR *create_variate_generator(int kind, gsl_rng *r,
+                                            ARENA *arena)
+{
+    VARIATE_GENERATOR *generator = (VARIATE_GENERATOR *)arena_allocate(
+        arena, sizeof(VARIATE_GENERATOR));
+    if (generator == NULL)
+    {
+        return NULL;
+    }
+    generator->r = r;
+    generator->kind = kind;
+    generator->mean = 0;
+    generator->std_dev = 0;
+    generator->rate = 0;
+    generator->num_values = 0;
+    generator->next = VARIATE_BLOCK_SIZE;
+
+    return generator;
+}
+
+/* Fills the tables of a generator for the numbers from first to last, taking
+them from the arena. The table is left empty if there would be too many
+numbers in it, or not enough memory for it, as every number can still be
+found by inversion. */
+void create_variate_table(VARIATE_GENERATOR *generator, double first,
+                          double last, ARENA *arena)
+{
+    if (last - first + 1 > MAX_VARIATE_TABLE_SIZE)
+    {
+        return;
+    }
+
+    int num_values = last - first + 1;
+    double *cumulative = (double *)arena_allocate(
+        arena, num_values * sizeof(double));
+    int *guide = (int *)arena_allocate(arena, num_values * sizeof(int));
+    if (cumulative == NULL || guide == NULL)
+    {
+        return;
+    }
+
+    generator->first = first;
+    generator->num_values = num_values;
+    generator->below = find_variate_cumulative(generator, first - 1);
+    generator->cumulative = cumulative;
+    generator->guide = guide;
+
+    int value;
+    for (value = 0; value < num_values; value++)
+    {
+        generator->cumulative[value] = find_variate_cumulative(
+            generator, first + value);
+    }
+
+    /* Guides each part of the uniform numbers to the first value which
+    covers its start. */
+    int part;
+    value = 0;
+    for (part = 0; part < num_values; part++)
+    {
+        while (value < num_values - 1 &&
+               generator->cumulative[value] < (double)part / num_values)
+        {
+            value++;
+        }
+        generator->guide[part] = value;
+    }
+}
+
+/* Finds the probability of the generator giving a number no higher than the
+given one. For the Gaussian distribution, this is the probability of a
+number which truncates to it, leaving out those which would be below 0. */
+double find_variate_cumulative(VARIATE_GENERATOR *generator, int value)
+{
+    if (generator->kind == POISSON_VARIATE)
+    {
+        if (value < 0)
+        {
+            return 0;
+        }
+        if (generator->rate <= 0)
+        {
+            return 1;
+        }
+        return gsl_cdf_poisson_P(value, generator->rate);
+    }
+
+    int mean = generator->mean;
+    int std_dev = generator->std_dev;
+    if (std_dev <= 0)
+    {
+        return value >= mean ? 1 : 0;
+    }
+    if (value < 0)
+    {
+        return 0;
+    }
+
+    double lowest = gsl_cdf_ugaussian_P((-1.0 - mean) / std_dev);
+    return (gsl_cdf_ugaussian_P((value + 1.0 - mean) / std_dev) - lowest) /
+           (1 - lowest);
+}
+
+/* Finds the number the generator gives for a uniform number by looking it
+up in the table, or by inverting the distribution if it is not covered. */
+int invert_variate(VARIATE_GENERATOR *generator, double u)
+{
+    int num_values = generator->num_values;
+    if (num_values == 0 || u <= generator->below ||
+        u > generator->cumulative[num_values - 1])
+    {
+        if (generator->kind == POISSON_VARIATE)
+        {
+            return invert_poisson(generator->rate, u);
+        }
+        return invert_gaussian(generator->mean, generator->std_dev, u);
+    }
+
+    int value = generator->guide[(int)(u * num_values)];
+    while (u > generator->cumulative[value])
+    {
+        value++;
+    }
+
+    return generator->first + value;
+}
+
+/* Makes the next block of numbers of a generator, taking all of the uniform
+numbers for it before looking any of them up. */
+void fill_variate_block(VARIATE_GENERATOR *generator)
+{
+    int number;
+    for (number = 0; number < VARIATE_BLOCK_SIZE; number++)
+    {
+        generator->uniforms[number] = gsl_rng_uniform_pos(generator->r);
+    }
+    for (number = 0; number < VARIATE_BLOCK_SIZE; number++)
+    {
+        generator->values[number] = invert_variate(
+            generator, generator->uniforms[number]);
+    }
+
+    generator->next = 0;
+}
+
+/* Gives the next number of a generator, making a new block of them if they
+have run out. */
+int next_variate(VARIATE_GENERATOR *generator)
+{
+    if (generator->next == VARIATE_BLOCK_SIZE)
+    {
+        fill_variate_block(generator);
+    }
+
+    return generator->values[generator->next++];
+}
+
+/* Creates a random number generator which gives the antithetic 1 - u of
+every uniform number u from another generator, or returns NULL if there is
+not enough memory. */
+gsl_rng *create_antithetic_rng(gsl_rng *base)
+{
+    gsl_rng *r = gsl_rng_alloc(&antithetic_rng_type);
+    if (r == NULL)
+    {
+        return NULL;
+    }
+    ((ANTITHETIC_STATE *)r->state)->base = base;
+
+    return r;
+}
+
+/* Seeds an antithetic generator, which does nothing as it only follows the
+generator it reads from. */
+void set_antithetic_rng(void *state, unsigned long seed)
+{
+    (void)state;
+    (void)seed;
+}
+
+/* Gives the antithetic of the next integer from the other generator. */
+unsigned long get_antithetic_rng(void *state)
+{
+    return get_antithetic_rng_double(state) * 4294967296.0;
+}
+
+/* Gives the antithetic of the next uniform number from the other
+generator, which is never 0 or 1. */
+double get_antithetic_rng_double(void *state)
+{
+    return 1 - gsl_rng_uniform_pos(((ANTITHETIC_STATE *)state)->base);
+}
@@ -3,14 +3,77 @@ distributions. */
 #ifndef __RANDOM_NUMBERS_H
 #define __RANDOM_NUMBERS_H
 
+#include <gsl/gsl_cdf.h>
 #include <gsl/gsl_rng.h>
 #include <gsl/gsl_randist.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <arena.h>
+
+/* Number of variates a generator makes at a time, which it hands out one by
+one until they run out. */
+#define VARIATE_BLOCK_SIZE 256
+
+/* Number of standard deviations either side of the mean covered by the
+table of a generator. Values outside of it are found by the slower
+inversion instead, which happens with negligible probability. */
+#define VARIATE_TABLE_SPREAD 10
+
+/* Largest number of values the table of a generator can have. Generators
+whose distribution is spread wider than this are not given a table. */
+#define MAX_VARIATE_TABLE_SIZE 65536
+
+/* Kinds of distributions a variate generator can draw from. */
+#define POISSON_VARIATE 0
+#define GAUSSIAN_VARIATE 1
+
+/* Variate generator structure, which turns blocks of uniform numbers into
+values by looking them up in a table of the cumulative probabilities of the
+values from first onwards. The guide table holds the first value which
+could cover each equal part of the uniform numbers, so that only one or two
+probabilities need to be compared for each. The values are the same as those
+generated one at a time, so antithetic pairs still work. */
+struct variate_generator
+{
+    gsl_rng *r;
+    int kind, mean, std_dev;
+    float rate;
+    int first, num_values, next;
+    double below;
+    double *cumulative;
+    int *guide;
+    double uniforms[VARIATE_BLOCK_SIZE];
+    int values[VARIATE_BLOCK_SIZE];
+};
+typedef struct variate_generator VARIATE_GENERATOR;
+
+/* State of an antithetic random number generator, holding the generator it
+reads from. */
+struct antithetic_state
+{
+    gsl_rng *base;
+};
+typedef struct antithetic_state ANTITHETIC_STATE;
+
 /* Random number generation functions. */
 int generate_random_poisson(float, gsl_rng *);
 int generate_random_gaussian(int, int, gsl_rng *);
+int invert_poisson(float, double);
+int invert_gaussian(int, int, double);
+VARIATE_GENERATOR *create_poisson_generator(float, gsl_rng *, ARENA *);
+VARIATE_GENERATOR *create_gaussian_generator(int, int, gsl_rng *, ARENA *);
+VARIATE_GENERATOR *create_variate_generator(int, gsl_rng *, ARENA *);
+void create_variate_table(VARIATE_GENERATOR *, double, double, ARENA *);
+double find_variate_cumulative(VARIATE_GENERATOR *, int);
+int invert_variate(VARIATE_GENERATOR *, double);
+void fill_variate_block(VARIATE_GENERATOR *);
+int next_variate(VARIATE_GENERATOR *);
+gsl_rng *create_antithetic_rng(gsl_rng *);
+void set_antithetic_rng(void *, unsigned long);
+unsigned long get_antithetic_rng(void *);
+double get_antithetic_rng_double(void *);
 
 #endif
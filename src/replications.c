@@ -0,0 +1,329 @@
+/* Runs many simulations of a Post Office branch across multiple threads. */
+#include <replications.h>
+
+/* Adds the results of the simulations from first up to last onto the totals
+of the batch once those of every simulation before them have been added,
+and saves a checkpoint if one is due. If the checkpoint cannot be written,
+the error is kept in the batch and no more simulations are taken. */
+void merge_in_order(BATCH *batch, int first, int last, RESULTS *results)
+{
+    pthread_mutex_lock(&batch->lock);
+    while (batch->next_merge != first)
+    {
+        pthread_cond_wait(&batch->merged, &batch->lock);
+    }
+
+    merge_results(batch->results, results);
+    batch->next_merge = last;
+    if (batch->checkpoint != NULL && batch->error == SIMQ_OK)
+    {
+        batch->error = save_checkpoint(batch->checkpoint, last,
+                                       batch->results);
+        batch->error_number = errno;
+    }
+
+    pthread_cond_broadcast(&batch->merged);
+    pthread_mutex_unlock(&batch->lock);
+}
+
+/* Runs the next simulation, or antithetic pair, no other thread has taken
+until there are none left in the batch, in a simulation context of its
+own. */
+void *run_worker(void *arg)
+{
+    WORKER *worker = (WORKER *)arg;
+    BATCH *batch = worker->batch;
+
+    SIMQ *simq;
+    SIMQ_CONFIG config;
+    set_simq_config(&config, batch->options);
+    exit_on_error(simq_init(&simq, batch->params, &config));
+
+    int num_run = 0;
+    long first_heap_allocations = 0;
+    while (1)
+    {
+        pthread_mutex_lock(&batch->lock);
+        int first = batch->next_simulation;
+        int last = first + batch->group_size - first % batch->group_size;
+        if (last > batch->last_simulation)
+        {
+            last = batch->last_simulation;
+        }
+        batch->next_simulation = last;
+        int error = batch->error;
+        pthread_mutex_unlock(&batch->lock);
+        if (first >= last || error != SIMQ_OK)
+        {
+            break;
+        }
+
+        int simulation;
+        for (simulation = first; simulation < last; simulation++)
+        {
+            exit_on_error(simq_run(simq, simulation, batch->output));
+
+            /* Counts the heap allocations made up to the end of the first
+            simulation, as the arena should not need any more after it. */
+            if (num_run++ == 0)
+            {
+                first_heap_allocations = simq_heap_allocations(simq);
+            }
+        }
+
+        RESULTS group_results;
+        simq_results(simq, &group_results);
+        simq_clear_results(simq);
+        merge_in_order(batch, first, last, &group_results);
+    }
+
+    worker->num_heap_allocations = simq_heap_allocations(simq);
+    worker->num_later_heap_allocations = worker->num_heap_allocations -
+                                         first_heap_allocations;
+
+    simq_destroy(simq);
+    return NULL;
+}
+
+/* Performs the simulations numbered from first up to last, sharing them out
+between the threads as they become free, and adding the results of each
+onto the totals in order. Antithetic pairs are run whole by one thread. If
+there is a checkpoint, it is saved to as the totals grow, returning an
+error code once every thread has finished if it could not be written.
+Records for each time interval are written to the output unless it is
+NULL. */
+int run_batch(PARAMETERS *params, OPTIONS *options, int first, int last,
+               RESULTS *results, OUTPUT *output, CHECKPOINT *checkpoint,
+               long *num_heap_allocations, long *num_later_heap_allocations)
+{
+    int num_threads = options->num_threads;
+    int group_size = options->antithetic ? 2 : 1;
+    int num_groups = (last - first + group_size - 1) / group_size;
+
+    /* There is no use in having more threads than simulations. */
+    if (num_threads > num_groups)
+    {
+        num_threads = num_groups;
+    }
+    if (num_threads < 1)
+    {
+        return SIMQ_OK;
+    }
+
+    WORKER *workers = NULL;
+    if (!(workers = (WORKER *)malloc(num_threads * sizeof(WORKER))))
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    BATCH batch;
+    batch.params = params;
+    batch.options = options;
+    batch.results = results;
+    batch.checkpoint = checkpoint;
+    batch.error = SIMQ_OK;
+    batch.next_simulation = first;
+    batch.next_merge = first;
+    batch.last_simulation = last;
+    batch.group_size = group_size;
+    pthread_mutex_init(&batch.lock, NULL);
+    pthread_cond_init(&batch.merged, NULL);
+
+    batch.output = output;
+
+    int thread;
+    for (thread = 0; thread < num_threads; thread++)
+    {
+        workers[thread].batch = &batch;
+    }
+
+    /* Runs on the calling thread when there is nothing to split. */
+    if (num_threads == 1)
+    {
+        run_worker(&workers[0]);
+    }
+    else
+    {
+        for (thread = 0; thread < num_threads; thread++)
+        {
+            int error = pthread_create(&workers[thread].thread, NULL,
+                                       run_worker, &workers[thread]);
+            if (error != 0)
+            {
+                fprintf(stderr, "Error %d: %s\n", error, strerror(error));
+                exit(EXIT_FAILURE);
+            }
+        }
+        for (thread = 0; thread < num_threads; thread++)
+        {
+            pthread_join(workers[thread].thread, NULL);
+        }
+    }
+
+    for (thread = 0; thread < num_threads; thread++)
+    {
+        *num_heap_allocations += workers[thread].num_heap_allocations;
+        *num_later_heap_allocations +=
+            workers[thread].num_later_heap_allocations;
+    }
+
+    pthread_cond_destroy(&batch.merged);
+    pthread_mutex_destroy(&batch.lock);
+    free(workers);
+
+    /* Gives back the reason the checkpoint could not be written, which was
+    found on another thread. */
+    if (batch.error != SIMQ_OK)
+    {
+        errno = batch.error_number;
+    }
+    return batch.error;
+}
+
+/* Finds the number of simulations in the next batch when running until a
+precision is reached, or 0 once every interval is narrow enough. The number
+is estimated from how far the intervals are from narrow enough. */
+int find_batch_size(RESULTS *results, OPTIONS *options, int num_simulations)
+{
+    double ratio = find_precision_ratio(results, options->precision);
+    if (ratio <= 1)
+    {
+        return 0;
+    }
+
+    /* Estimates the simulations still needed from the half-width shrinking
+    with the square root of the number of simulations, using at least every
+    thread and whole antithetic pairs. */
+    double needed = ceil(num_simulations * (ratio * ratio - 1));
+    int batch_size = options->num_threads;
+    if (needed > batch_size)
+    {
+        batch_size = needed < INT_MAX / 2 ? needed : INT_MAX / 2;
+    }
+    if (options->antithetic && batch_size % 2 == 1)
+    {
+        batch_size++;
+    }
+
+    return batch_size;
+}
+
+/* Performs the simulations, returning how many were run. If a precision is
+given, batches are run until the confidence interval of each key result is
+within that fraction of its average, up to the number of simulations given.
+If a checkpoint file is given, the progress is saved to it as the
+simulations run, and resuming carries on from it to the same results as a
+run which was never stopped. If a single simulation is asked for, only that
+one is run, with the same random numbers it has in the whole run. */
+int run_replications(PARAMETERS *params, OPTIONS *options, RESULTS *results,
+                     OUTPUT *output)
+{
+    int max_simulations = options->num_simulations;
+    int num_simulations = 0;
+    long num_heap_allocations = 0;
+    long num_later_heap_allocations = 0;
+
+    /* Displays a record for each time interval if only one simulation is
+    being performed, unless they are not wanted anywhere. Later batches of a
+    run with more simulations never have records. */
+    OUTPUT *records = NULL;
+    if ((options->replication >= 0 || max_simulations == 1) &&
+        wants_interval_records(output))
+    {
+        records = output;
+    }
+
+    if (options->replication >= 0)
+    {
+        exit_on_error(run_batch(params, options, options->replication,
+                                options->replication + 1, results, records,
+                                NULL, &num_heap_allocations,
+                                &num_later_heap_allocations));
+        return 1;
+    }
+
+    int batch_first = 0;
+    int batch_size = max_simulations;
+    if (options->precision > 0)
+    {
+        batch_size = MIN_SEQUENTIAL_SIMULATIONS;
+    }
+
+    /* Takes the totals of the finished simulations from the checkpoint when
+    resuming, and carries on with the batch they are in, or the next one if
+    it had finished. */
+    CHECKPOINT latest;
+    CHECKPOINT *checkpoint = NULL;
+    if (options->checkpoint_file != NULL)
+    {
+        checkpoint = &latest;
+        create_checkpoint(checkpoint, options, params);
+        if (options->resume)
+        {
+            read_checkpoint(checkpoint, results);
+            num_simulations = checkpoint->header.num_finished;
+            batch_first = checkpoint->header.batch_first;
+            batch_size = checkpoint->header.batch_size;
+            if (num_simulations == batch_first + batch_size)
+            {
+                batch_first = num_simulations;
+                batch_size = options->precision > 0
+                                 ? find_batch_size(results, options,
+                                                   num_simulations)
+                                 : 0;
+            }
+        }
+    }
+
+    while (num_simulations < max_simulations && batch_size > 0)
+    {
+        if (batch_size > max_simulations - batch_first)
+        {
+            batch_size = max_simulations - batch_first;
+        }
+        if (checkpoint != NULL)
+        {
+            start_checkpoint_batch(checkpoint, batch_first, batch_size);
+        }
+        exit_on_error(run_batch(params, options, num_simulations,
+                                batch_first + batch_size, results, records,
+                                checkpoint, &num_heap_allocations,
+                                &num_later_heap_allocations));
+        num_simulations = batch_first + batch_size;
+
+        if (checkpoint != NULL)
+        {
+            exit_on_error(
+                write_checkpoint(checkpoint, num_simulations, results));
+        }
+
+        if (options->precision <= 0)
+        {
+            break;
+        }
+
+        /* Stops once every interval is narrow enough. */
+        batch_first = num_simulations;
+        batch_size = find_batch_size(results, options, num_simulations);
+    }
+
+    if (checkpoint != NULL)
+    {
+        free_checkpoint(checkpoint);
+    }
+
+    if (options->alloc_stats)
+    {
+        int num_threads = options->num_threads;
+        if (num_threads > num_simulations)
+        {
+            num_threads = num_simulations;
+        }
+        output_allocation_stats(num_simulations, num_threads,
+                                num_heap_allocations,
+                                num_later_heap_allocations);
+    }
+
+    return num_simulations;
+}
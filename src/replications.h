@@ -0,0 +1,65 @@
+/* Header file for running many simulations of a Post Office branch across
+multiple threads. */
+#ifndef __REPLICATIONS_H
+#define __REPLICATIONS_H
+
+#include <errno.h>
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_randist.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <arena.h>
+#include <checkpoint.h>
+#include <cli.h>
+#include <input_output.h>
+#include <options.h>
+#include <service_points.h>
+#include <libsimq.h>
+#include <simulation.h>
+
+/* Number of simulations in the first batch when running until a precision
+is reached, so there are enough for a first estimate of the spread. */
+#define MIN_SEQUENTIAL_SIMULATIONS 10
+
+/* Batch structure holding the state shared by the threads of a batch, which
+take the next simulation, or antithetic pair, in turn. Their results are
+added onto the totals in the order of the simulations, so the totals do not
+depend on the number of threads. The first error in saving the checkpoint
+is kept along with its reason. */
+struct batch
+{
+    PARAMETERS *params;
+    OPTIONS *options;
+    OUTPUT *output;
+    RESULTS *results;
+    CHECKPOINT *checkpoint;
+    int error, error_number;
+    int next_simulation, next_merge, last_simulation, group_size;
+    pthread_mutex_t lock;
+    pthread_cond_t merged;
+};
+typedef struct batch BATCH;
+
+/* Worker structure holding the state owned by a single thread. */
+struct worker
+{
+    BATCH *batch;
+    long num_heap_allocations, num_later_heap_allocations;
+    pthread_t thread;
+};
+typedef struct worker WORKER;
+
+/* Replication function prototypes. */
+void merge_in_order(BATCH *, int, int, RESULTS *);
+void *run_worker(void *);
+int run_batch(PARAMETERS *, OPTIONS *, int, int, RESULTS *, OUTPUT *,
+              CHECKPOINT *, long *, long *);
+int find_batch_size(RESULTS *, OPTIONS *, int);
+int run_replications(PARAMETERS *, OPTIONS *, RESULTS *, OUTPUT *);
+
+#endif
@@ -0,0 +1,355 @@
+/* Serves requests to simulate scenarios, read one per line from the standard
+input or a local socket, for as long as the program is running. */
+#include <server.h>
+
+/* Reads a request from a line of the form
+<id> <the 8 parameters> <number of simulations> <seed>
+with the parameters in the same order as the input file. The identifier is
+read whenever the line is not blank, so that an error can be given back
+with it. Returns an error code if the line cannot be read or has invalid
+values. */
+int read_request(char *line, REQUEST *request)
+{
+    float *parameters = request->parameters;
+    char extra;
+
+    /* The width of the identifier is one less than MAX_REQUEST_ID. */
+    request->id[0] = '\0';
+    int num_read = sscanf(line, "%63s %f %f %f %f %f %f %f %f %d %lu %c",
+                          request->id, &parameters[0], &parameters[1],
+                          &parameters[2], &parameters[3], &parameters[4],
+                          &parameters[5], &parameters[6], &parameters[7],
+                          &request->num_simulations, &request->seed, &extra);
+    if (num_read != 3 + NUM_PARAMETERS || request->num_simulations < 1)
+    {
+        return SIMQ_ERROR_PARAMETERS;
+    }
+
+    return check_parameter_values(parameters);
+}
+
+/* Adds a request onto the end of those waiting for a thread, waiting for
+one to be taken first if there is no space for it. */
+void add_request(SERVER *server, REQUEST *request)
+{
+    pthread_mutex_lock(&server->lock);
+    while (server->num_waiting == REQUEST_QUEUE_SIZE)
+    {
+        pthread_cond_wait(&server->request_taken, &server->lock);
+    }
+
+    int last = (server->first_request + server->num_waiting) %
+               REQUEST_QUEUE_SIZE;
+    server->requests[last] = *request;
+    server->num_waiting++;
+    server->num_pending++;
+
+    pthread_cond_signal(&server->request_added);
+    pthread_mutex_unlock(&server->lock);
+}
+
+/* Takes the first of the waiting requests, waiting for one to be added if
+there are none. Returns 0 once the server is stopping and none are left. */
+int take_request(SERVER *server, REQUEST *request)
+{
+    pthread_mutex_lock(&server->lock);
+    while (server->num_waiting == 0 && !server->stopping)
+    {
+        pthread_cond_wait(&server->request_added, &server->lock);
+    }
+    if (server->num_waiting == 0)
+    {
+        pthread_mutex_unlock(&server->lock);
+        return 0;
+    }
+
+    *request = server->requests[server->first_request];
+    server->first_request = (server->first_request + 1) % REQUEST_QUEUE_SIZE;
+    server->num_waiting--;
+
+    pthread_cond_signal(&server->request_taken);
+    pthread_mutex_unlock(&server->lock);
+    return 1;
+}
+
+/* Runs the simulations of a request and writes its averages back to the
+client, or the reason they could not be run. The simulation context of the
+thread is created for its first request, and reused for every one after
+it. Each request has the seed it was given, so its results do not depend on
+which thread simulated it or what was simulated before it. */
+void answer_request(SERVER *server, REQUEST *request, SIMQ **simq)
+{
+    PARAMETERS params;
+    RESULTS results;
+    int error = SIMQ_OK;
+
+    set_parameters(&params, request->parameters);
+    if (*simq == NULL)
+    {
+        SIMQ_CONFIG config;
+        set_simq_config(&config, server->options);
+        error = simq_init(simq, &params, &config);
+    }
+    if (error == SIMQ_OK)
+    {
+        error = simq_set_parameters(*simq, &params, request->seed);
+    }
+
+    int simulation;
+    for (simulation = 0;
+         error == SIMQ_OK && simulation < request->num_simulations;
+         simulation++)
+    {
+        error = simq_run(*simq, simulation, NULL);
+    }
+    if (*simq != NULL)
+    {
+        simq_results(*simq, &results);
+        simq_clear_results(*simq);
+    }
+
+    pthread_mutex_lock(&server->output_lock);
+    if (error == SIMQ_OK)
+    {
+        output_server_results(server->fp, request->id,
+                              request->num_simulations,
+                              results.num_fulfilled,
+                              results.fulfilled_wait_time,
+                              results.num_unfulfilled, results.num_timed_out,
+                              results.time_after_closing);
+    }
+    else
+    {
+        output_server_error(server->fp, request->id,
+                            simq_error_message(error));
+    }
+    flush_if_idle(server);
+    pthread_mutex_unlock(&server->output_lock);
+
+    pthread_mutex_lock(&server->lock);
+    if (--server->num_pending == 0)
+    {
+        pthread_cond_broadcast(&server->requests_answered);
+    }
+    pthread_mutex_unlock(&server->lock);
+}
+
+/* Flushes the answers written to the client once no more requests are
+waiting, so that answers are sent together while the threads are busy. The
+output lock must be held. */
+void flush_if_idle(SERVER *server)
+{
+    pthread_mutex_lock(&server->lock);
+    int num_waiting = server->num_waiting;
+    pthread_mutex_unlock(&server->lock);
+
+    if (num_waiting == 0)
+    {
+        fflush(server->fp);
+    }
+}
+
+/* Answers one waiting request after another, reusing the same simulation
+context for all of them, until the server stops. */
+void *run_server_worker(void *arg)
+{
+    SERVER_WORKER *worker = (SERVER_WORKER *)arg;
+    SIMQ *simq = NULL;
+    REQUEST request;
+
+    while (take_request(worker->server, &request))
+    {
+        answer_request(worker->server, &request, &simq);
+    }
+
+    simq_destroy(simq);
+    return NULL;
+}
+
+/* Reads the requests of a client until it has no more, adding them to those
+waiting for a thread, then waits for all of them to be answered. Blank lines
+are skipped, and requests which cannot be read are answered straight
+away. */
+void serve_client(SERVER *server, FILE *in, FILE *out)
+{
+    char line[MAX_REQUEST_LENGTH];
+    REQUEST request;
+    int c;
+
+    pthread_mutex_lock(&server->output_lock);
+    server->fp = out;
+    pthread_mutex_unlock(&server->output_lock);
+
+    while (fgets(line, MAX_REQUEST_LENGTH, in) != NULL)
+    {
+        int error = read_request(line, &request);
+
+        /* Skips the rest of a line which is too long to be a request. */
+        if (strchr(line, '\n') == NULL && !feof(in))
+        {
+            while ((c = getc(in)) != EOF && c != '\n')
+            {
+            }
+            error = SIMQ_ERROR_PARAMETERS;
+        }
+
+        if (request.id[0] == '\0')
+        {
+            continue;
+        }
+        if (error == SIMQ_OK)
+        {
+            add_request(server, &request);
+        }
+        else
+        {
+            pthread_mutex_lock(&server->output_lock);
+            output_server_error(out, request.id, REQUEST_ERROR_MESSAGE);
+            flush_if_idle(server);
+            pthread_mutex_unlock(&server->output_lock);
+        }
+    }
+
+    pthread_mutex_lock(&server->lock);
+    while (server->num_pending > 0)
+    {
+        pthread_cond_wait(&server->requests_answered, &server->lock);
+    }
+    pthread_mutex_unlock(&server->lock);
+
+    fflush(out);
+}
+
+/* Creates a local socket at the given path and listens on it for clients.
+A socket left at the path by an earlier server is replaced, but any other
+file there is not. */
+int open_server_socket(char *socket_file)
+{
+    struct sockaddr_un address;
+    struct stat status;
+
+    if (strlen(socket_file) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "The path of the socket is too long!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (stat(socket_file, &status) == 0 && S_ISSOCK(status.st_mode))
+    {
+        unlink(socket_file);
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_file);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 ||
+        bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+        listen(listener, SOCKET_BACKLOG) != 0)
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    return listener;
+}
+
+/* Serves requests from the standard input until it ends, writing the answers
+to the standard output, or from one client of the socket after another
+until the program is stopped. The threads keep their simulation contexts
+for every request, so that nothing is set up again for each one. */
+void run_server(OPTIONS *options)
+{
+    SERVER server;
+    SERVER_WORKER *workers = NULL;
+    if (!(server.requests = (REQUEST *)malloc(REQUEST_QUEUE_SIZE *
+                                              sizeof(REQUEST))) ||
+        !(workers = (SERVER_WORKER *)malloc(options->num_threads *
+                                            sizeof(SERVER_WORKER))))
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    /* Carries on serving if a client goes away before it is answered. */
+    signal(SIGPIPE, SIG_IGN);
+
+    server.first_request = 0;
+    server.num_waiting = 0;
+    server.num_pending = 0;
+    server.stopping = 0;
+    server.fp = stdout;
+    server.options = options;
+    pthread_mutex_init(&server.lock, NULL);
+    pthread_mutex_init(&server.output_lock, NULL);
+    pthread_cond_init(&server.request_added, NULL);
+    pthread_cond_init(&server.request_taken, NULL);
+    pthread_cond_init(&server.requests_answered, NULL);
+
+    int thread;
+    for (thread = 0; thread < options->num_threads; thread++)
+    {
+        workers[thread].server = &server;
+
+        int error = pthread_create(&workers[thread].thread, NULL,
+                                   run_server_worker, &workers[thread]);
+        if (error != 0)
+        {
+            fprintf(stderr, "Error %d: %s\n", error, strerror(error));
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (options->socket_file == NULL)
+    {
+        serve_client(&server, stdin, stdout);
+    }
+    else
+    {
+        int listener = open_server_socket(options->socket_file);
+        while (1)
+        {
+            int client = accept(listener, NULL, NULL);
+            if (client < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+
+            /* Reads and writes the client through separate streams, so that
+            closing one does not close the socket under the other. */
+            FILE *in = fdopen(client, "r");
+            FILE *out = fdopen(dup(client), "w");
+            if (in == NULL || out == NULL)
+            {
+                fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+            serve_client(&server, in, out);
+            fclose(out);
+            fclose(in);
+        }
+    }
+
+    /* Stops the threads once every request has been answered. */
+    pthread_mutex_lock(&server.lock);
+    server.stopping = 1;
+    pthread_cond_broadcast(&server.request_added);
+    pthread_mutex_unlock(&server.lock);
+    for (thread = 0; thread < options->num_threads; thread++)
+    {
+        pthread_join(workers[thread].thread, NULL);
+    }
+
+    pthread_cond_destroy(&server.requests_answered);
+    pthread_cond_destroy(&server.request_taken);
+    pthread_cond_destroy(&server.request_added);
+    pthread_mutex_destroy(&server.output_lock);
+    pthread_mutex_destroy(&server.lock);
+    free(workers);
+    free(server.requests);
+}
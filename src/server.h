@@ -0,0 +1,91 @@
+/* Header file for serving requests to simulate scenarios, read one per line
+from the standard input or a local socket, for as long as the program is
+running. */
+#ifndef __SERVER_H
+#define __SERVER_H
+
+/* Needed for sockets, signals and opening a stream on a socket. */
+#define _POSIX_C_SOURCE 200112L
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <input_output.h>
+#include <libsimq.h>
+#include <options.h>
+#include <simulation.h>
+
+/* Longest request line which can be read, including its newline. */
+#define MAX_REQUEST_LENGTH 512
+
+/* Longest identifier a request can have, including its terminator. */
+#define MAX_REQUEST_ID 64
+
+/* Number of requests which can wait for a free thread before no more are
+read. */
+#define REQUEST_QUEUE_SIZE 1024
+
+/* Number of connections to the socket which can wait to be served. */
+#define SOCKET_BACKLOG 16
+
+/* Message given back for a request which cannot be read or has invalid
+values. */
+#define REQUEST_ERROR_MESSAGE "The request must be an identifier followed " \
+                              "by the 8 parameters, the number of " \
+                              "simulations and the seed, with valid values"
+
+/* Request structure holding a scenario to simulate, with the identifier its
+results are given back with, the values of the parameters in the same order
+as the input file, the number of simulations and their seed. */
+struct request
+{
+    char id[MAX_REQUEST_ID];
+    float parameters[NUM_PARAMETERS];
+    int num_simulations;
+    unsigned long seed;
+};
+typedef struct request REQUEST;
+
+/* Server structure holding the requests which are waiting, in a circular
+buffer, and the stream of the client the results are written to. The
+number of pending requests also counts those being simulated. */
+struct server
+{
+    REQUEST *requests;
+    int first_request, num_waiting, num_pending, stopping;
+    FILE *fp;
+    OPTIONS *options;
+    pthread_mutex_t lock, output_lock;
+    pthread_cond_t request_added, request_taken, requests_answered;
+};
+typedef struct server SERVER;
+
+/* Server worker structure holding the state owned by a single thread, which
+takes the next waiting request until the server stops. */
+struct server_worker
+{
+    SERVER *server;
+    pthread_t thread;
+};
+typedef struct server_worker SERVER_WORKER;
+
+/* Server function prototypes. */
+int read_request(char *, REQUEST *);
+void add_request(SERVER *, REQUEST *);
+int take_request(SERVER *, REQUEST *);
+void answer_request(SERVER *, REQUEST *, SIMQ **);
+void flush_if_idle(SERVER *);
+void *run_server_worker(void *);
+void serve_client(SERVER *, FILE *, FILE *);
+int open_server_socket(char *);
+void run_server(OPTIONS *);
+
+#endif
@@ -1,41 +1,130 @@
 /* Handles service points in a Post Office branch. */
 #include <service_points.h>
 
-/* Creates the empty service points to start with. */
-int *create_service_points(int num_service_points)
+/* Creates the empty service points to start with, or returns NULL if there
+is not enough memory. */
+SERVICE_POINTS *create_service_points(int num_service_points)
 {
-    int point;
     /* Dynamically allocates memory based on the number of service points. */
-    int *service_points = NULL;
-    if (!(service_points = (int *)malloc(num_service_points * sizeof(int))))
+    SERVICE_POINTS *service_points = NULL;
+    if (!(service_points = (SERVICE_POINTS *)malloc(sizeof(SERVICE_POINTS))))
+    {
+        return NULL;
+    }
+    service_points->free_points = (int *)malloc(num_service_points *
+                                                sizeof(int));
+    service_points->completion_times = (int *)malloc(num_service_points *
+                                                     sizeof(int));
+    service_points->next_points = (int *)malloc(num_service_points *
+                                                sizeof(int));
+    service_points->buckets = (int *)malloc(NUM_COMPLETION_BUCKETS *
+                                            sizeof(int));
+    if (service_points->free_points == NULL ||
+        service_points->completion_times == NULL ||
+        service_points->next_points == NULL ||
+        service_points->buckets == NULL)
     {
-        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
-        exit(EXIT_FAILURE);
-    };
+        free_service_points(service_points);
+        return NULL;
+    }
+
+    reset_service_points(service_points, num_service_points);
+
+    return service_points;
+}
 
-    /* Assigns each service point to represent them being empty. */
+/* Makes the given number of service points available, all of them free,
+which must be no more than the number the service points were created
+with. */
+void reset_service_points(SERVICE_POINTS *service_points,
+                          int num_service_points)
+{
+    int point;
+
+    /* Puts every service point on the stack of free points, with the first
+    point at the top. */
     for (point = 0; point < num_service_points; point++)
     {
-        service_points[point] = 0;
+        service_points->free_points[point] = num_service_points - 1 - point;
     }
+    service_points->num_service_points = num_service_points;
+    service_points->num_free = num_service_points;
+    service_points->num_busy = 0;
 
-    return service_points;
+    /* Starts the completion wheel with every bucket empty. */
+    int bucket;
+    for (bucket = 0; bucket < NUM_COMPLETION_BUCKETS; bucket++)
+    {
+        service_points->buckets[bucket] = -1;
+    }
+}
+
+/* Frees the memory used by the service points. */
+void free_service_points(SERVICE_POINTS *service_points)
+{
+    free(service_points->free_points);
+    free(service_points->completion_times);
+    free(service_points->next_points);
+    free(service_points->buckets);
+    free(service_points);
 }
 
 /* Counts the number of people being served in the service points. */
-int count_busy_service_points(int num_service_points, int *service_points)
+int count_busy_service_points(SERVICE_POINTS *service_points)
 {
-    int num_being_served = 0;
+    return service_points->num_busy;
+}
 
-    /* Iterates to check for service points which are being used. */
-    int point;
-    for (point = 0; point < num_service_points; point++)
+/* Gives a customer taking the given number of minutes to a free service
+point, returning the point or -1 if they are all busy. */
+int start_service(SERVICE_POINTS *service_points, int time_slice, int mins)
+{
+    if (service_points->num_free == 0)
+    {
+        return -1;
+    }
+
+    int point = service_points->free_points[--service_points->num_free];
+    int completion_time = time_slice + mins;
+    int bucket = completion_time & (NUM_COMPLETION_BUCKETS - 1);
+
+    service_points->completion_times[point] = completion_time;
+    service_points->next_points[point] = service_points->buckets[bucket];
+    service_points->buckets[bucket] = point;
+    service_points->num_busy++;
+
+    return point;
+}
+
+/* Frees every service point whose customer has been fully served on the
+given time slice, returning how many were freed. Only the points in the
+bucket of the completion wheel for this time slice are checked, so it must
+be called on every time slice. */
+int finish_services(SERVICE_POINTS *service_points, int time_slice)
+{
+    int *completion_times = service_points->completion_times;
+    int *next_points = service_points->next_points;
+    int *link = &service_points->buckets[time_slice &
+                                         (NUM_COMPLETION_BUCKETS - 1)];
+    int num_finished = 0;
+
+    while (*link != -1)
     {
-        if (service_points[point] != 0)
+        int point = *link;
+
+        /* Leaves points due on a later turn of the wheel in place. */
+        if (completion_times[point] != time_slice)
         {
-            num_being_served++;
+            link = &next_points[point];
+            continue;
         }
+
+        /* Unlinks the point and puts it on the stack of free points. */
+        *link = next_points[point];
+        service_points->free_points[service_points->num_free++] = point;
+        num_finished++;
     }
 
-    return num_being_served;
+    service_points->num_busy -= num_finished;
+    return num_finished;
 }
@@ -7,8 +7,30 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Number of buckets in the completion wheel, which must be a power of two.
+Points whose customer will finish further away than this stay in their
+bucket until the wheel comes round to it again. */
+#define NUM_COMPLETION_BUCKETS 256
+
+/* Service points structure, keeping a stack of the points which are free
+and a timing wheel of the busy points, where each bucket is a list of the
+points whose customer will have been fully served on a time slice equal to
+the bucket modulo the number of buckets. The time slice and the next point
+in the list are kept in arrays by point, with -1 ending a list, so freeing
+the points due on a time slice only looks at those in its bucket. */
+struct service_points
+{
+    int *free_points, *completion_times, *next_points, *buckets;
+    int num_service_points, num_free, num_busy;
+};
+typedef struct service_points SERVICE_POINTS;
+
 /* Service point function prototypes. */
-int *create_service_points(int);
-int count_busy_service_points(int, int *);
+SERVICE_POINTS *create_service_points(int);
+void reset_service_points(SERVICE_POINTS *, int);
+void free_service_points(SERVICE_POINTS *);
+int count_busy_service_points(SERVICE_POINTS *);
+int start_service(SERVICE_POINTS *, int, int);
+int finish_services(SERVICE_POINTS *, int);
 
 #endif
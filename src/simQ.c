@@ -4,166 +4,200 @@
 
 int main(int argc, char **argv)
 {
-    const gsl_rng_type *T;
-    gsl_rng *r;
+    /* Takes the configuration from the parameters. */
+    OPTIONS options;
+    read_options(argc, argv, &options);
+    int num_simulations = options.num_simulations;
 
-    /* Creates a random number generator. */
-    gsl_rng_env_setup();
-    T = gsl_rng_default;
-    r = gsl_rng_alloc(T);
+    /* Serves requests to simulate scenarios until there are no more
+    instead, with the scenarios and seeds given in the requests. */
+    if (options.serve)
+    {
+        run_server(&options);
+        return EXIT_SUCCESS;
+    }
 
-    /* Seeds the random number generator based on current time. */
-    gsl_rng_set(r, time(0));
+    /* Takes the seed of the run it was started with when resuming. */
+    if (options.resume)
+    {
+        read_checkpoint_seed(&options);
+    }
 
-    /* Checks that enough parameters have been passed into the program. */
-    if (argc != 4)
+    /* Simulates every branch with an input file in the directory instead,
+    writing a table with a row of results for each and for the region. */
+    if (options.network)
     {
-        fprintf(stderr, "Not enough parameters passed in! You must provide "
-                        "the input file, number of simulations, and "
-                        "output file.");
-        exit(EXIT_FAILURE);
+        NETWORK network;
+        read_network_directory(options.input_parameters, &network);
+
+        OUTPUT output;
+        exit_on_error(
+            open_output(&output, options.results_file, NULL, 1, 0, 1));
+        run_network(&network, &options, &output);
+
+        exit_on_error(close_output(&output));
+        free_network(&network);
+        return EXIT_SUCCESS;
     }
 
-    /* Checks that the second parameter input by the user is a digit. */
-    if (!isdigit(*argv[2]))
+    /* Configuration variables from the input file. */
+    float parameters[NUM_PARAMETERS];
+    PARAMETERS params;
+    exit_on_error(simq_read_parameters(options.input_parameters, parameters,
+                                       &params));
+
+    /* Simulates every combination of the ranges in the sweep file instead,
+    writing a table with a row of results for each. */
+    if (options.sweep_file != NULL)
     {
-        fprintf(stderr, "You have not input a digit for the number of "
-                        "simulations!");
-        exit(EXIT_FAILURE);
+        SWEEP sweep;
+        read_sweep_file(options.sweep_file, parameters, &sweep);
+
+        OUTPUT output;
+        exit_on_error(
+            open_output(&output, options.results_file, NULL, 1, 0, 1));
+        if (options.analytic_only)
+        {
+            run_analytic_sweep(&sweep, &params, &output);
+        }
+        else
+        {
+            run_sweep(&sweep, &params, &options, &output);
+        }
+
+        exit_on_error(close_output(&output));
+        return EXIT_SUCCESS;
     }
 
-    /* Takes the configuration from the parameters. */
-    char *input_parameters = argv[1];
-    int num_simulations = atoi(argv[2]);
-    char *results_file = argv[3];
-    float *parameters = (float *)read_parameter_file(input_parameters);
+    /* Searches for the fewest service points meeting the targets in the
+    staffing file instead, writing a table with a row for each maximum
+    queue length. */
+    if (options.staffing_file != NULL)
+    {
+        STAFFING staffing;
+        read_staffing_file(options.staffing_file, parameters, &staffing);
 
-    /* Configuration variables from the input file. */
-    int max_queue_length = parameters[0];
-    int num_service_points = parameters[1];
-    int closing_time = parameters[2];
-    float avg_customer_rate = parameters[3];
-    float mean_mins = parameters[4];
-    float std_dev_mins = parameters[5];
-    float mean_tolerance = parameters[6];
-    float std_dev_tolerance = parameters[7];
-
-    /* Removes queue length limit if set to -1. */
-    if (max_queue_length == -1)
+        OUTPUT output;
+        exit_on_error(
+            open_output(&output, options.results_file, NULL, 1, 0, 1));
+        find_staffing(&staffing, parameters, &params, &options, &output);
+
+        exit_on_error(close_output(&output));
+        return EXIT_SUCCESS;
+    }
+
+    /* Variables for the output of the simulations. */
+    RESULTS results;
+    create_empty_results(&results);
+
+    /* Opens the results file and outputs parameter values. */
+    OUTPUT output;
+    exit_on_error(open_output(&output, options.results_file,
+                              options.trace_file, options.record_interval,
+                              options.flush_interval, options.summary_only));
+    exit_on_error(output_parameters(
+        &output, params.max_queue_length, params.num_service_points,
+        params.closing_time, params.avg_customer_rate, params.mean_mins,
+        params.std_dev_mins, params.mean_tolerance,
+        params.std_dev_tolerance));
+    int customer_class;
+    for (customer_class = 1; customer_class < params.num_classes;
+         customer_class++)
+    {
+        CUSTOMER_CLASS *current = &params.classes[customer_class];
+        output_class_parameters(&output, current->name,
+                                current->avg_customer_rate,
+                                current->mean_mins, current->std_dev_mins,
+                                current->mean_tolerance,
+                                current->std_dev_tolerance,
+                                current->priority);
+    }
+    if (has_arrival_schedule(&params.schedule))
     {
-        max_queue_length = INT_MAX;
+        output_arrival_schedule(&output, params.schedule.num_segments,
+                                params.schedule.starts,
+                                params.schedule.multiples);
     }
 
-    /* Variables for the running/output of the simulations. */
-    int simulation;
-    int num_customers = 0;
-    int num_fulfilled = 0;
-    int num_unfulfilled = 0;
-    int num_timed_out = 0;
-    int fulfilled_wait_time = 0;
-    int time_after_closing = 0;
-    int time_slice;
-    int closed = 0;
-
-    /* Outputs parameter values. */
-    output_parameters(results_file, max_queue_length, num_service_points,
-                      closing_time, avg_customer_rate, mean_mins, std_dev_mins,
-                      mean_tolerance, std_dev_tolerance);
-
-    /* Creates service points and displays them at the start. */
-    int *service_points = (int *)create_service_points(num_service_points);
-
-    for (simulation = 0; simulation < num_simulations; simulation++)
+    /* Outputs the estimates from queueing theory, and stops there if they
+    are all that was asked for. */
+    if (options.analytic || options.analytic_only)
     {
-        /* Performs the simulation(s). */
-        QUEUE *q = create_empty_queue(max_queue_length);
-        time_slice = 0;
-        closed = 0;
-        while (closed == 0)
-        {
-            /* Serves customers currently on the service points. */
-            num_fulfilled = serve_customers(num_fulfilled, num_service_points,
-                                            service_points);
-
-            /* Checks if service points are available for the next customer. */
-            if (!(is_queue_empty(q)))
-            {
-                fulfilled_wait_time = fulfil_customer(q, num_service_points,
-                                                      service_points,
-                                                      fulfilled_wait_time);
-            }
-
-            /* Updates the time waited of every customer in the queue. */
-            increment_waiting_times(q);
-            num_timed_out = leave_queue_early(q, num_timed_out);
-
-            /* Adds new customers to the queue if not past closing time. */
-            if (time_slice <= closing_time)
-            {
-                int new_customer;
-                int num_new_customers = generate_random_poisson(
-                    avg_customer_rate, r);
-                for (new_customer = 0; new_customer < num_new_customers;
-                     new_customer++)
-                {
-                    num_customers++;
-                    /* Marks the customer as unfulfilled if queue is full. */
-                    if (q->queue_length == max_queue_length)
-                    {
-                        num_unfulfilled++;
-                    }
-                    /* Adds customer to the queue if there is space. */
-                    else
-                    {
-                        enqueue(q, mean_mins, std_dev_mins, mean_tolerance,
-                                std_dev_tolerance, r);
-                    }
-                }
-            }
-
-            /* Displays a record for each time interval if only one
- *  *             simulation is being performed. */
-            if (num_simulations == 1)
-            {
-                int num_being_served = count_busy_service_points(
-                    num_service_points, service_points);
-                output_interval_record(results_file, time_slice, closing_time,
-                                       num_being_served, q->queue_length,
-                                       num_fulfilled, num_unfulfilled,
-                                       num_timed_out);
-            }
-
-            /* Stops the simulation. */
-            time_slice++;
-            if (time_slice > closing_time &&
-                is_branch_empty(q, num_service_points, service_points))
-            {
-                time_after_closing += time_slice - closing_time - 1;
-                closed = 1;
-                free(q);
-            }
-        }
+        output_branch_estimate(&output, &params);
     }
+    if (options.analytic_only)
+    {
+        exit_on_error(close_output(&output));
+        return EXIT_SUCCESS;
+    }
+    output_seed(&output, options.seed, options.replication);
+
+    /* Performs the simulation(s), split between the threads, and takes how
+    many were needed if running until a precision is reached. */
+    num_simulations = run_replications(&params, &options, &results,
+                                       &output);
 
     /* Outputs to the results file for multiple simulations. */
     if (num_simulations == 1)
     {
-        output_results_sing(results_file, time_after_closing, num_fulfilled,
-                            fulfilled_wait_time);
+        output_results_sing(&output, results.time_after_closing,
+                            results.num_fulfilled,
+                            results.fulfilled_wait_time);
     }
     /* Outputs to the results file for multiple simulations. */
     else if (num_simulations > 1)
     {
-        output_results_mult(results_file, num_simulations, num_customers,
-                            num_fulfilled, fulfilled_wait_time,
-                            num_unfulfilled, num_timed_out,
-                            time_after_closing);
+        output_results_mult(&output, num_simulations,
+                            results.num_customers, results.num_fulfilled,
+                            results.fulfilled_wait_time,
+                            results.num_unfulfilled, results.num_timed_out,
+                            results.time_after_closing,
+                            sqrt(find_variance(&results.wait.running)),
+                            find_standard_error(&results.simulation_wait),
+                            find_confidence_half_width(
+                                &results.simulation_wait),
+                            find_sample_quantile(&results.wait, 0.5),
+                            find_sample_quantile(&results.wait, 0.9),
+                            find_sample_quantile(&results.wait, 0.99));
+
+        /* Outputs the variance reduction from antithetic pairs. */
+        if (options.antithetic)
+        {
+            output_variance_reduction(&output, num_simulations,
+                                      results.pair_wait.count,
+                                      find_variance_reduction(&results));
+        }
+
+        /* Outputs the confidence intervals the simulations stopped at. */
+        if (options.precision > 0)
+        {
+            output_confidence_intervals(
+                &output, num_simulations,
+                find_precision_ratio(&results, options.precision) <= 1,
+                find_confidence_half_width(&results.simulation_unfulfilled),
+                find_confidence_half_width(&results.simulation_timed_out));
+        }
     }
 
-    gsl_rng_free(r);
-    free(parameters);
-    free(service_points);
-    return EXIT_SUCCESS;
-}
+#ifdef PHASE_TIMING
+    /* Outputs the time spent in each phase of the time slices. */
+    output_phase_timings(&results.timings);
+#endif
 
+    /* Outputs the averages of each class if there is more than one. */
+    for (customer_class = 0;
+         customer_class < params.num_classes && params.num_classes > 1 &&
+         num_simulations > 0;
+         customer_class++)
+    {
+        CLASS_RESULTS *totals = &results.classes[customer_class];
+        output_class_results(&output, params.classes[customer_class].name,
+                             num_simulations, totals->num_customers,
+                             totals->num_fulfilled,
+                             totals->fulfilled_wait_time,
+                             totals->num_unfulfilled, totals->num_timed_out);
+    }
 
+    exit_on_error(close_output(&output));
+    return EXIT_SUCCESS;
+}
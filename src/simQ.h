@@ -4,17 +4,26 @@ using linked lists. */
 #define __SIMQ_H
 
 #include <errno.h>
-#include <gsl/gsl_rng.h>
-#include <gsl/gsl_randist.h>
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
+#include <analytic.h>
+#include <cli.h>
 #include <customer.h>
 #include <input_output.h>
+#include <network.h>
+#include <options.h>
 #include <queue.h>
 #include <random_numbers.h>
+#include <replications.h>
+#include <server.h>
 #include <service_points.h>
+#include <libsimq.h>
+#include <simulation.h>
+#include <staffing.h>
+#include <sweep.h>
 
 #endif
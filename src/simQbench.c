@@ -0,0 +1,357 @@
+/* Measures how quickly the parts of the simulation and whole simulations run,
+writing a row of comma-separated values for each measurement so that the
+results of different versions can be compared. */
+#include <simQbench.h>
+
+/* Numbers of waiting customers and of service points each microbenchmark is
+run with. */
+static const int benchmark_queue_lengths[NUM_BENCHMARK_SIZES] = {16, 256,
+                                                                 4096, 65536};
+static const int benchmark_service_points[NUM_BENCHMARK_SIZES] = {1, 8, 64,
+                                                                  512};
+
+int main(int argc, char **argv)
+{
+    /* Checks that enough parameters have been passed into the program. */
+    if (argc < 2)
+    {
+        fprintf(stderr, "You must provide the output file, followed by any "
+                        "input files to time whole simulations of.");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Seeds the random number generator the same way every time, so that
+    every version is timed on the same customers. */
+    gsl_rng_env_setup();
+    gsl_rng *r = gsl_rng_alloc(gsl_rng_default);
+    gsl_rng_set(r, 1);
+
+    OUTPUT output;
+    exit_on_error(open_output(&output, argv[1], NULL, 1, 0, 1));
+    fprintf(output.fp, "benchmark,input,queue_length,num_service_points,"
+                       "operations,seconds,operations_per_second\n");
+
+    /* Customers have the task length and tolerance of the example input
+    file, with one arriving every minute. */
+    float parameters[] = {0, 1, 540, 1, 5, 2, 5, 2};
+    PARAMETERS params;
+    set_parameters(&params, parameters);
+
+    ARENA *arena = create_arena(ARENA_SIZE);
+    if (arena == NULL)
+    {
+        exit_on_error(SIMQ_ERROR_MEMORY);
+    }
+    int size, points;
+    for (size = 0; size < NUM_BENCHMARK_SIZES; size++)
+    {
+        int queue_length = benchmark_queue_lengths[size];
+        benchmark_enqueue_dequeue(&output, &params, arena, r, queue_length);
+        benchmark_leave_queue_early(&output, &params, arena, r,
+                                    queue_length);
+        for (points = 0; points < NUM_BENCHMARK_SIZES; points++)
+        {
+            benchmark_fulfil_customer(&output, &params, arena, r,
+                                      queue_length,
+                                      benchmark_service_points[points]);
+        }
+    }
+    for (points = 0; points < NUM_BENCHMARK_SIZES; points++)
+    {
+        benchmark_serve_customers(&output, arena, r,
+                                  benchmark_service_points[points]);
+    }
+    benchmark_random_numbers(&output, arena, r);
+    free_arena(arena);
+
+    /* Times whole simulations of each input file with both engines. */
+    int input;
+    for (input = 2; input < argc; input++)
+    {
+        benchmark_simulations(&output, argv[input], 0);
+        benchmark_simulations(&output, argv[input], 1);
+    }
+
+    exit_on_error(close_output(&output));
+    gsl_rng_free(r);
+    return EXIT_SUCCESS;
+}
+
+/* Outputs a row for a measurement, with the time taken since it started. */
+void output_benchmark(OUTPUT *output, char *name, char *input,
+                      int queue_length, int num_service_points,
+                      long num_operations, clock_t start)
+{
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    fprintf(output->fp, "%s,%s,%d,%d,%ld,%f,%f\n", name, input, queue_length,
+            num_service_points, num_operations, seconds,
+            seconds > 0 ? num_operations / seconds : 0);
+}
+
+/* Times a customer joining the end of a queue of the given length and the
+customer at the front leaving it to be served. The customers never leave
+early, so the timing wheel is not used. */
+void benchmark_enqueue_dequeue(OUTPUT *output, PARAMETERS *params,
+                               ARENA *arena, gsl_rng *r, int queue_length)
+{
+    reset_arena(arena);
+    QUEUE *q = create_empty_queue(queue_length, params->classes,
+                                  params->num_classes, arena);
+    VARIATE_GENERATOR *mins_generator = create_gaussian_generator(
+        params->mean_mins, params->std_dev_mins, r, arena);
+    VARIATE_GENERATOR *tolerance_generator = create_gaussian_generator(
+        0, 0, r, arena);
+    if (q == NULL || mins_generator == NULL || tolerance_generator == NULL)
+    {
+        exit_on_error(SIMQ_ERROR_MEMORY);
+    }
+
+    int time_slice;
+    for (time_slice = 0; time_slice < queue_length; time_slice++)
+    {
+        exit_on_error(enqueue(q, 0, 0, mins_generator, tolerance_generator));
+    }
+
+    clock_t start = clock();
+    for (time_slice = 0; time_slice < NUM_BENCHMARK_OPERATIONS; time_slice++)
+    {
+        enqueue(q, time_slice, 0, mins_generator, tolerance_generator);
+        dequeue(q);
+    }
+    output_benchmark(output, "enqueue_dequeue", "", queue_length, 0,
+                     NUM_BENCHMARK_OPERATIONS, start);
+}
+
+/* Times a time slice of a queue of the given length where one customer
+joins and another leaves early, as every customer tolerates waiting for as
+many minutes as there are customers. Queues longer than the timing wheel
+also pass over the customers due on a later turn of it. */
+void benchmark_leave_queue_early(OUTPUT *output, PARAMETERS *params,
+                                 ARENA *arena, gsl_rng *r, int queue_length)
+{
+    reset_arena(arena);
+    QUEUE *q = create_empty_queue(queue_length, params->classes,
+                                  params->num_classes, arena);
+    VARIATE_GENERATOR *mins_generator = create_gaussian_generator(
+        params->mean_mins, params->std_dev_mins, r, arena);
+    VARIATE_GENERATOR *tolerance_generator = create_gaussian_generator(
+        queue_length, 0, r, arena);
+    if (q == NULL || mins_generator == NULL || tolerance_generator == NULL)
+    {
+        exit_on_error(SIMQ_ERROR_MEMORY);
+    }
+    RESULTS results;
+    create_empty_results(&results);
+
+    /* Fills the queue until the first customer is about to leave. */
+    int time_slice;
+    for (time_slice = 0; time_slice < queue_length; time_slice++)
+    {
+        exit_on_error(enqueue(q, time_slice, 0, mins_generator,
+                              tolerance_generator));
+    }
+
+    clock_t start = clock();
+    long num_timed_out = 0;
+    int last = queue_length + NUM_BENCHMARK_OPERATIONS;
+    for (; time_slice < last; time_slice++)
+    {
+        enqueue(q, time_slice, 0, mins_generator, tolerance_generator);
+        num_timed_out = leave_queue_early(q, time_slice, num_timed_out,
+                                          &results.timed_out_wait,
+                                          results.classes);
+    }
+    output_benchmark(output, "leave_queue_early", "", queue_length, 0,
+                     NUM_BENCHMARK_OPERATIONS, start);
+}
+
+/* Times a time slice of a branch with the given number of service points,
+where a free point is given the next customer from a queue of the given
+length, which is then filled up again. */
+void benchmark_fulfil_customer(OUTPUT *output, PARAMETERS *params,
+                               ARENA *arena, gsl_rng *r, int queue_length,
+                               int num_service_points)
+{
+    reset_arena(arena);
+    SERVICE_POINTS *service_points = create_service_points(
+        num_service_points);
+    QUEUE *q = create_empty_queue(queue_length, params->classes,
+                                  params->num_classes, arena);
+    VARIATE_GENERATOR *mins_generator = create_gaussian_generator(
+        params->mean_mins, params->std_dev_mins, r, arena);
+    VARIATE_GENERATOR *tolerance_generator = create_gaussian_generator(
+        0, 0, r, arena);
+    if (service_points == NULL || q == NULL || mins_generator == NULL ||
+        tolerance_generator == NULL)
+    {
+        exit_on_error(SIMQ_ERROR_MEMORY);
+    }
+    RESULTS results;
+    create_empty_results(&results);
+
+    int time_slice;
+    for (time_slice = 0; time_slice < queue_length; time_slice++)
+    {
+        exit_on_error(enqueue(q, 0, 0, mins_generator, tolerance_generator));
+    }
+
+    clock_t start = clock();
+    for (time_slice = 0; time_slice < NUM_BENCHMARK_OPERATIONS; time_slice++)
+    {
+        results.num_fulfilled = serve_customers(
+            results.num_fulfilled, service_points, time_slice);
+        results.fulfilled_wait_time = fulfil_customer(
+            q, service_points, results.fulfilled_wait_time, &results.wait,
+            results.classes, time_slice);
+        while (q->queue_length < queue_length)
+        {
+            enqueue(q, time_slice, 0, mins_generator, tolerance_generator);
+        }
+    }
+    output_benchmark(output, "fulfil_customer", "", queue_length,
+                     num_service_points, NUM_BENCHMARK_OPERATIONS, start);
+
+    free_service_points(service_points);
+}
+
+/* Times a time slice of a branch with the given number of service points,
+where the points whose customers have been served are freed and then given
+new customers straight away, with fewer time slices for more points. */
+void benchmark_serve_customers(OUTPUT *output, ARENA *arena, gsl_rng *r,
+                               int num_service_points)
+{
+    reset_arena(arena);
+    SERVICE_POINTS *service_points = create_service_points(
+        num_service_points);
+    VARIATE_GENERATOR *mins_generator = create_gaussian_generator(5, 2, r,
+                                                                  arena);
+    if (service_points == NULL || mins_generator == NULL)
+    {
+        exit_on_error(SIMQ_ERROR_MEMORY);
+    }
+
+    clock_t start = clock();
+    long num_fulfilled = 0;
+    int num_time_slices = NUM_BENCHMARK_OPERATIONS / num_service_points;
+    int time_slice;
+    for (time_slice = 0; time_slice < num_time_slices; time_slice++)
+    {
+        num_fulfilled = serve_customers(num_fulfilled, service_points,
+                                        time_slice);
+
+        /* A task taking no time leaves the service point free. */
+        int num_free = service_points->num_free;
+        while (num_free-- > 0)
+        {
+            int mins = next_variate(mins_generator);
+            if (mins > 0)
+            {
+                start_service(service_points, time_slice, mins);
+            }
+        }
+    }
+    output_benchmark(output, "serve_customers", "", 0, num_service_points,
+                     num_time_slices, start);
+
+    free_service_points(service_points);
+}
+
+/* Times generating random numbers one at a time by inverting their
+distributions, and from the tables of generators. */
+void benchmark_random_numbers(OUTPUT *output, ARENA *arena, gsl_rng *r)
+{
+    reset_arena(arena);
+    VARIATE_GENERATOR *poisson_generator = create_poisson_generator(0.5, r,
+                                                                    arena);
+    VARIATE_GENERATOR *gaussian_generator = create_gaussian_generator(
+        5, 2, r, arena);
+    if (poisson_generator == NULL || gaussian_generator == NULL)
+    {
+        exit_on_error(SIMQ_ERROR_MEMORY);
+    }
+    long total = 0;
+    int number;
+
+    clock_t start = clock();
+    for (number = 0; number < NUM_BENCHMARK_OPERATIONS; number++)
+    {
+        total += generate_random_poisson(0.5, r);
+    }
+    output_benchmark(output, "generate_random_poisson", "", 0, 0,
+                     NUM_BENCHMARK_OPERATIONS, start);
+
+    start = clock();
+    for (number = 0; number < NUM_BENCHMARK_OPERATIONS; number++)
+    {
+        total += generate_random_gaussian(5, 2, r);
+    }
+    output_benchmark(output, "generate_random_gaussian", "", 0, 0,
+                     NUM_BENCHMARK_OPERATIONS, start);
+
+    start = clock();
+    for (number = 0; number < NUM_BENCHMARK_OPERATIONS; number++)
+    {
+        total += next_variate(poisson_generator);
+    }
+    output_benchmark(output, "next_variate_poisson", "", 0, 0,
+                     NUM_BENCHMARK_OPERATIONS, start);
+
+    start = clock();
+    for (number = 0; number < NUM_BENCHMARK_OPERATIONS; number++)
+    {
+        total += next_variate(gaussian_generator);
+    }
+    output_benchmark(output, "next_variate_gaussian", "", 0, 0,
+                     NUM_BENCHMARK_OPERATIONS, start);
+
+    /* Uses the total so the numbers cannot be left ungenerated. */
+    if (total < 0)
+    {
+        fprintf(stderr, "The random numbers should never be negative!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Times whole simulations of an input file on a single thread with the tick
+or event engine, giving the number of simulations per second. */
+void benchmark_simulations(OUTPUT *output, char *input_parameters,
+                           int event_driven)
+{
+    PARAMETERS params;
+    exit_on_error(simq_read_parameters(input_parameters, NULL, &params));
+
+    /* Runs the simulations as the simulation would without any options. */
+    OPTIONS options;
+    options.input_parameters = input_parameters;
+    options.results_file = NULL;
+    options.num_simulations = NUM_BENCHMARK_SIMULATIONS;
+    options.num_threads = 1;
+    options.event_driven = event_driven;
+    options.resolution = 1;
+    options.alloc_stats = 0;
+    options.record_interval = 1;
+    options.flush_interval = 0;
+    options.summary_only = 1;
+    options.trace_file = NULL;
+    options.sweep_file = NULL;
+    options.antithetic = 0;
+    options.network = 0;
+    options.precision = 0;
+    options.checkpoint_file = NULL;
+    options.checkpoint_interval = DEFAULT_CHECKPOINT_INTERVAL;
+    options.resume = 0;
+    options.seed = 1;
+    options.seeded = 1;
+    options.replication = -1;
+
+    RESULTS results;
+    create_empty_results(&results);
+
+    clock_t start = clock();
+    int num_simulations = run_replications(&params, &options, &results,
+                                           output);
+    output_benchmark(output, event_driven ? "simulations_event"
+                                          : "simulations_tick",
+                     input_parameters, params.max_queue_length,
+                     params.num_service_points, num_simulations, start);
+}
@@ -0,0 +1,48 @@
+/* Header file for measuring how quickly the parts of the simulation and whole
+simulations run. */
+#ifndef __SIMQBENCH_H
+#define __SIMQBENCH_H
+
+#include <errno.h>
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_randist.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <arena.h>
+#include <cli.h>
+#include <customer.h>
+#include <input_output.h>
+#include <options.h>
+#include <queue.h>
+#include <random_numbers.h>
+#include <replications.h>
+#include <service_points.h>
+#include <libsimq.h>
+#include <simulation.h>
+
+/* Number of operations timed by each microbenchmark, which is shared
+between the service points of those timing time slices of a branch, and of
+simulations timed for each engine and input file. */
+#define NUM_BENCHMARK_OPERATIONS 1000000
+#define NUM_BENCHMARK_SIMULATIONS 1000
+
+/* Number of sizes of queue and of numbers of service points each
+microbenchmark is run with. */
+#define NUM_BENCHMARK_SIZES 4
+
+/* Benchmark function prototypes. */
+void output_benchmark(OUTPUT *, char *, char *, int, int, long, clock_t);
+void benchmark_enqueue_dequeue(OUTPUT *, PARAMETERS *, ARENA *, gsl_rng *,
+                               int);
+void benchmark_leave_queue_early(OUTPUT *, PARAMETERS *, ARENA *, gsl_rng *,
+                                 int);
+void benchmark_fulfil_customer(OUTPUT *, PARAMETERS *, ARENA *, gsl_rng *,
+                               int, int);
+void benchmark_serve_customers(OUTPUT *, ARENA *, gsl_rng *, int);
+void benchmark_random_numbers(OUTPUT *, ARENA *, gsl_rng *);
+void benchmark_simulations(OUTPUT *, char *, int);
+
+#endif
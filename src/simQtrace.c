@@ -0,0 +1,121 @@
+/* Converts a binary trace of a simulation into the text format of the results
+file, or into comma-separated values. */
+#include <simQtrace.h>
+
+int main(int argc, char **argv)
+{
+    /* Checks that enough parameters have been passed into the program. */
+    if (argc != 3 && !(argc == 4 && strcmp(argv[3], "--csv") == 0))
+    {
+        fprintf(stderr, "You must provide the trace file and output file, "
+                        "followed by --csv for comma-separated values.");
+        exit(EXIT_FAILURE);
+    }
+
+    TRACE trace;
+    open_trace(&trace, argv[1]);
+    TRACE_HEADER *header = trace.header;
+
+    OUTPUT output;
+    exit_on_file_error(open_output(&output, argv[2], NULL, 1, 0, 0));
+
+    long record;
+    if (argc == 4)
+    {
+        /* Outputs a row for each record after a row naming the columns. */
+        fprintf(output.fp, "time_slice,num_being_served,queue_length,"
+                           "num_fulfilled,num_unfulfilled,num_timed_out\n");
+        for (record = 0; record < trace.num_records; record++)
+        {
+            TRACE_RECORD *r = &trace.records[record];
+            fprintf(output.fp, "%d,%d,%d,%d,%d,%d\n", r->time_slice,
+                    r->num_being_served, r->queue_length, r->num_fulfilled,
+                    r->num_unfulfilled, r->num_timed_out);
+        }
+    }
+    else
+    {
+        /* Outputs the parameters and records as the simulation would. */
+        exit_on_file_error(output_parameters(
+            &output, header->max_queue_length, header->num_service_points,
+            header->closing_time, header->avg_customer_rate,
+            header->mean_mins, header->std_dev_mins, header->mean_tolerance,
+            header->std_dev_tolerance));
+        for (record = 0; record < trace.num_records; record++)
+        {
+            TRACE_RECORD *r = &trace.records[record];
+            exit_on_file_error(output_interval_record(
+                &output, r->time_slice, header->closing_time,
+                r->num_being_served, r->queue_length, r->num_fulfilled,
+                r->num_unfulfilled, r->num_timed_out, 0));
+        }
+    }
+
+    exit_on_file_error(close_output(&output));
+    close_trace(&trace);
+    return EXIT_SUCCESS;
+}
+
+/* Exits with the reason a file could not be written, which is always left
+in errno, if there was an error. */
+void exit_on_file_error(int error)
+{
+    if (error != SIMQ_OK)
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Maps a trace into memory so its records can be read in place, checking
+that it was written in this format. */
+void open_trace(TRACE *trace, char *trace_file)
+{
+    int fd;
+    struct stat file_status;
+
+    if ((fd = open(trace_file, O_RDONLY)) == -1 ||
+        fstat(fd, &file_status) == -1)
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    trace->size = file_status.st_size;
+    if (trace->size < sizeof(TRACE_HEADER))
+    {
+        fprintf(stderr, "%s is too short to be a trace!\n", trace_file);
+        exit(EXIT_FAILURE);
+    }
+
+    trace->memory = mmap(NULL, trace->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (trace->memory == MAP_FAILED)
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+
+    /* Checks the header before trusting the size of the records. */
+    trace->header = (TRACE_HEADER *)trace->memory;
+    if (memcmp(trace->header->magic, TRACE_MAGIC,
+               sizeof(trace->header->magic)) != 0 ||
+        trace->header->version != TRACE_VERSION ||
+        trace->header->record_size != sizeof(TRACE_RECORD))
+    {
+        fprintf(stderr, "%s is not a trace of a version which can be "
+                        "read!\n",
+                trace_file);
+        exit(EXIT_FAILURE);
+    }
+
+    trace->records = (TRACE_RECORD *)(trace->header + 1);
+    trace->num_records = (trace->size - sizeof(TRACE_HEADER)) /
+                         sizeof(TRACE_RECORD);
+}
+
+/* Unmaps a trace from memory. */
+void close_trace(TRACE *trace)
+{
+    munmap(trace->memory, trace->size);
+}
@@ -0,0 +1,34 @@
+/* Header file for converting binary traces of a simulation into text. */
+#ifndef __SIMQTRACE_H
+#define __SIMQTRACE_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <errors.h>
+#include <input_output.h>
+#include <trace.h>
+
+/* Trace structure for reading a trace which has been mapped into memory. */
+struct trace
+{
+    void *memory;
+    size_t size;
+    TRACE_HEADER *header;
+    TRACE_RECORD *records;
+    long num_records;
+};
+typedef struct trace TRACE;
+
+/* Trace reading function prototypes. */
+void exit_on_file_error(int);
+void open_trace(TRACE *, char *);
+void close_trace(TRACE *);
+
+#endif
@@ -0,0 +1,938 @@
+/* Runs a single simulation of a Post Office branch. */
+#include <simulation.h>
+
+/* Sets the parameters from the values read from the input file. */
+void set_parameters(PARAMETERS *params, float *parameters)
+{
+    params->max_queue_length = parameters[0];
+    params->num_service_points = parameters[1];
+    params->closing_time = parameters[2];
+    params->avg_customer_rate = parameters[3];
+    params->mean_mins = parameters[4];
+    params->std_dev_mins = parameters[5];
+    params->mean_tolerance = parameters[6];
+    params->std_dev_tolerance = parameters[7];
+
+    /* Removes queue length limit if set to -1. */
+    if (params->max_queue_length == -1)
+    {
+        params->max_queue_length = INT_MAX;
+    }
+
+    /* Sets the standard class from the main parameters, as the only class
+    until any others are added. */
+    CUSTOMER_CLASS *standard = &params->classes[0];
+    strcpy(standard->name, "standard");
+    standard->avg_customer_rate = params->avg_customer_rate;
+    standard->mean_mins = params->mean_mins;
+    standard->std_dev_mins = params->std_dev_mins;
+    standard->mean_tolerance = params->mean_tolerance;
+    standard->std_dev_tolerance = params->std_dev_tolerance;
+    standard->priority = 0;
+    params->num_classes = 1;
+
+    /* Customers arrive at the average rate all day until a schedule is
+    added. */
+    create_constant_schedule(&params->schedule);
+}
+
+/* Adds the classes of customer after the standard class of one set of
+parameters onto another. */
+void add_customer_classes(PARAMETERS *params, PARAMETERS *from)
+{
+    int customer_class;
+    for (customer_class = 1; customer_class < from->num_classes;
+         customer_class++)
+    {
+        params->classes[params->num_classes++] =
+            from->classes[customer_class];
+    }
+}
+
+/* Sets all of the running totals and statistics to zero before any
+simulations. */
+void create_empty_results(RESULTS *results)
+{
+    results->num_customers = 0;
+    results->num_fulfilled = 0;
+    results->num_unfulfilled = 0;
+    results->num_timed_out = 0;
+    results->fulfilled_wait_time = 0;
+    results->time_after_closing = 0;
+    int customer_class;
+    for (customer_class = 0; customer_class < MAX_CUSTOMER_CLASSES;
+         customer_class++)
+    {
+        CLASS_RESULTS *totals = &results->classes[customer_class];
+        totals->num_customers = 0;
+        totals->num_fulfilled = 0;
+        totals->num_unfulfilled = 0;
+        totals->num_timed_out = 0;
+        totals->fulfilled_wait_time = 0;
+    }
+    create_sample_stats(&results->wait);
+    create_running_stats(&results->timed_out_wait);
+    create_running_stats(&results->simulation_fulfilled);
+    create_running_stats(&results->simulation_unfulfilled);
+    create_running_stats(&results->simulation_timed_out);
+    create_running_stats(&results->simulation_wait);
+    create_running_stats(&results->pair_wait);
+    create_phase_timings(&results->timings);
+}
+
+/* Adds the running totals and statistics from one set of simulations onto
+another. */
+void merge_results(RESULTS *total, RESULTS *results)
+{
+    total->num_customers += results->num_customers;
+    total->num_fulfilled += results->num_fulfilled;
+    total->num_unfulfilled += results->num_unfulfilled;
+    total->num_timed_out += results->num_timed_out;
+    total->fulfilled_wait_time += results->fulfilled_wait_time;
+    total->time_after_closing += results->time_after_closing;
+    int customer_class;
+    for (customer_class = 0; customer_class < MAX_CUSTOMER_CLASSES;
+         customer_class++)
+    {
+        CLASS_RESULTS *totals = &total->classes[customer_class];
+        CLASS_RESULTS *class_results = &results->classes[customer_class];
+        totals->num_customers += class_results->num_customers;
+        totals->num_fulfilled += class_results->num_fulfilled;
+        totals->num_unfulfilled += class_results->num_unfulfilled;
+        totals->num_timed_out += class_results->num_timed_out;
+        totals->fulfilled_wait_time += class_results->fulfilled_wait_time;
+    }
+    merge_sample_stats(&total->wait, &results->wait);
+    merge_running_stats(&total->timed_out_wait, &results->timed_out_wait);
+    merge_running_stats(&total->simulation_fulfilled,
+                        &results->simulation_fulfilled);
+    merge_running_stats(&total->simulation_unfulfilled,
+                        &results->simulation_unfulfilled);
+    merge_running_stats(&total->simulation_timed_out,
+                        &results->simulation_timed_out);
+    merge_running_stats(&total->simulation_wait, &results->simulation_wait);
+    merge_running_stats(&total->pair_wait, &results->pair_wait);
+    merge_phase_timings(&total->timings, &results->timings);
+}
+
+/* Finds the average waiting time of the fulfilled customers, which is 0 if
+there are none. */
+double find_average_wait(RESULTS *results)
+{
+    if (results->num_fulfilled == 0)
+    {
+        return 0;
+    }
+
+    return results->fulfilled_wait_time / results->num_fulfilled;
+}
+
+/* Finds how many times lower the variance of the average waiting time of an
+antithetic pair is than that of two independent simulations, returning 0
+if there are too few pairs to tell. */
+double find_variance_reduction(RESULTS *results)
+{
+    double pair_variance = find_variance(&results->pair_wait);
+    if (results->pair_wait.count < 2 || pair_variance <= 0)
+    {
+        return 0;
+    }
+
+    return find_variance(&results->simulation_wait) / 2 / pair_variance;
+}
+
+/* Finds the half-width of the confidence interval of the average of a
+result over the simulations as a fraction of the average. An interval of no
+width is always narrow enough, even around an average of 0. */
+double find_relative_half_width(RUNNING_STATS *stats)
+{
+    double half_width = find_confidence_half_width(stats);
+    if (half_width == 0)
+    {
+        return 0;
+    }
+    if (stats->mean == 0)
+    {
+        return HUGE_VAL;
+    }
+
+    return half_width / fabs(stats->mean);
+}
+
+/* Finds how many times wider than the precision the widest confidence
+interval is, out of the average waiting time of fulfilled customers and the
+numbers of customers unfulfilled and timed out. Antithetic pairs only make
+the intervals wider than they need to be, so they can still be used. */
+double find_precision_ratio(RESULTS *results, float precision)
+{
+    double widths[3];
+    widths[0] = find_relative_half_width(&results->simulation_wait);
+    widths[1] = find_relative_half_width(&results->simulation_unfulfilled);
+    widths[2] = find_relative_half_width(&results->simulation_timed_out);
+
+    double ratio = 0;
+    int result;
+    for (result = 0; result < 3; result++)
+    {
+        if (widths[result] / precision > ratio)
+        {
+            ratio = widths[result] / precision;
+        }
+    }
+
+    return ratio;
+}
+
+/* Finds the number of customers of every class arriving per minute in a
+segment of the arrival schedule. */
+float find_arrival_rate(PARAMETERS *params, int segment)
+{
+    float rate = 0;
+    int customer_class;
+    for (customer_class = 0; customer_class < params->num_classes;
+         customer_class++)
+    {
+        rate += params->classes[customer_class].avg_customer_rate *
+                params->schedule.multiples[segment];
+    }
+
+    return rate;
+}
+
+/* Creates the generators of the task lengths and tolerances of each class of
+customer from the arena. Returns an error code if there is not enough memory
+for them. */
+int create_class_generators(PARAMETERS *params, gsl_rng *customer_r,
+                            ARENA *arena,
+                            VARIATE_GENERATOR **mins_generators,
+                            VARIATE_GENERATOR **tolerance_generators)
+{
+    int customer_class;
+    for (customer_class = 0; customer_class < params->num_classes;
+         customer_class++)
+    {
+        CUSTOMER_CLASS *current = &params->classes[customer_class];
+        mins_generators[customer_class] = create_gaussian_generator(
+            current->mean_mins, current->std_dev_mins, customer_r, arena);
+        tolerance_generators[customer_class] = create_gaussian_generator(
+            current->mean_tolerance, current->std_dev_tolerance, customer_r,
+            arena);
+        if (mins_generators[customer_class] == NULL ||
+            tolerance_generators[customer_class] == NULL)
+        {
+            return SIMQ_ERROR_MEMORY;
+        }
+    }
+
+    return SIMQ_OK;
+}
+
+/* Finds the minute the segment of the arrival schedule after the given one
+starts, or INT_MAX if it is the last. */
+int find_next_segment_start(ARRIVAL_SCHEDULE *schedule, int segment)
+{
+    if (segment + 1 < schedule->num_segments)
+    {
+        return schedule->starts[segment + 1];
+    }
+
+    return INT_MAX;
+}
+
+/* Creates the generators of the numbers of arrivals of each class in each
+minute of a segment of the arrival schedule from the arena, so that the
+rates are only worked out once per segment rather than every minute.
+Returns an error code if there is not enough memory for them. */
+int create_arrival_generators(PARAMETERS *params, int segment,
+                              gsl_rng *arrival_r, ARENA *arena,
+                              VARIATE_GENERATOR **arrival_generators)
+{
+    int customer_class;
+    for (customer_class = 0; customer_class < params->num_classes;
+         customer_class++)
+    {
+        float rate = params->classes[customer_class].avg_customer_rate *
+                     params->schedule.multiples[segment];
+        if (!(arrival_generators[customer_class] =
+                  create_poisson_generator(rate, arrival_r, arena)))
+        {
+            return SIMQ_ERROR_MEMORY;
+        }
+    }
+
+    return SIMQ_OK;
+}
+
+/* Moves the time-sliced simulation on to a segment of the arrival schedule,
+with new generators of the numbers of arrivals in each time slice. Returns
+an error code if there is not enough memory for them. */
+int start_arrival_segment(SIMULATION *simulation, int segment)
+{
+    PARAMETERS *params = simulation->params;
+
+    simulation->segment = segment;
+    simulation->next_segment_start = find_next_segment_start(
+        &params->schedule, segment);
+    simulation->arrival_rate = find_arrival_rate(params, segment);
+
+    return create_arrival_generators(params, segment, simulation->arrival_r,
+                                     simulation->arena,
+                                     simulation->arrival_generators);
+}
+
+/* Starts simulating the branch from opening, adding onto the running totals
+as it goes. The queue and the generators of random numbers are taken from
+the arena. Arrivals and customers are drawn from separate random number
+generators. A record is output for each time interval if an output is
+given. Returns an error code if there is not enough memory. */
+int start_simulation(SIMULATION *simulation, PARAMETERS *params,
+                     SERVICE_POINTS *service_points, ARENA *arena,
+                     gsl_rng *arrival_r, gsl_rng *customer_r,
+                     RESULTS *results, OUTPUT *output)
+{
+    simulation->params = params;
+    simulation->service_points = service_points;
+    simulation->arena = arena;
+    simulation->arrival_r = arrival_r;
+    simulation->results = results;
+    simulation->output = output;
+    simulation->time_slice = 0;
+    simulation->closed = 0;
+
+    if (!(simulation->q = create_empty_queue(params->max_queue_length,
+                                             params->classes,
+                                             params->num_classes, arena)))
+    {
+        return SIMQ_ERROR_MEMORY;
+    }
+
+    if (create_class_generators(params, customer_r, arena,
+                                simulation->mins_generators,
+                                simulation->tolerance_generators) != SIMQ_OK)
+    {
+        return SIMQ_ERROR_MEMORY;
+    }
+
+    return start_arrival_segment(simulation, 0);
+}
+
+/* Simulates a single time slice, closing the branch once it is past closing
+time and the last customer has left. The customers of each class arrive in
+the order of the classes within a time slice. Returns an error code if there
+is not enough memory for the customers who arrive, or the record cannot be
+written. */
+int step_simulation(SIMULATION *simulation)
+{
+    PARAMETERS *params = simulation->params;
+    SERVICE_POINTS *service_points = simulation->service_points;
+    QUEUE *q = simulation->q;
+    RESULTS *results = simulation->results;
+    int time_slice = simulation->time_slice;
+
+    START_PHASES(&results->timings);
+
+    /* Serves customers currently on the service points. */
+    results->num_fulfilled = serve_customers(results->num_fulfilled,
+                                             service_points, time_slice);
+    END_PHASE(&results->timings, SERVE_PHASE);
+
+    /* Gives the next waiting customer a service point if one is
+    available. */
+    results->fulfilled_wait_time = fulfil_customer(
+        q, service_points, results->fulfilled_wait_time, &results->wait,
+        results->classes, time_slice);
+    END_PHASE(&results->timings, FULFIL_PHASE);
+
+    /* Removes customers who have reached the end of their tolerance. */
+    results->num_timed_out = leave_queue_early(
+        q, time_slice, results->num_timed_out, &results->timed_out_wait,
+        results->classes);
+    END_PHASE(&results->timings, LEAVE_PHASE);
+
+    /* Moves on to the next segment of the arrival schedule once it
+    starts. */
+    if (time_slice == simulation->next_segment_start &&
+        start_arrival_segment(simulation, simulation->segment + 1) !=
+            SIMQ_OK)
+    {
+        return SIMQ_ERROR_MEMORY;
+    }
+
+    /* Adds new customers to the queue if not past closing time. */
+    int customer_class;
+    for (customer_class = 0;
+         customer_class < params->num_classes &&
+         time_slice <= params->closing_time;
+         customer_class++)
+    {
+        CLASS_RESULTS *totals = &results->classes[customer_class];
+        int new_customer;
+        int num_new_customers = next_variate(
+            simulation->arrival_generators[customer_class]);
+        for (new_customer = 0; new_customer < num_new_customers;
+             new_customer++)
+        {
+            results->num_customers++;
+            totals->num_customers++;
+            /* Marks the customer as unfulfilled if queue is full. */
+            if (q->queue_length == params->max_queue_length)
+            {
+                results->num_unfulfilled++;
+                totals->num_unfulfilled++;
+            }
+            /* Adds customer to the queue if there is space. */
+            else if (enqueue(q, time_slice, customer_class,
+                             simulation->mins_generators[customer_class],
+                             simulation->tolerance_generators
+                                 [customer_class]) != SIMQ_OK)
+            {
+                return SIMQ_ERROR_MEMORY;
+            }
+        }
+    }
+    END_PHASE(&results->timings, ARRIVAL_PHASE);
+
+    /* Displays a record for each time interval if asked to. */
+    if (simulation->output != NULL &&
+        output_interval_record(simulation->output, time_slice,
+                               params->closing_time,
+                               count_busy_service_points(service_points),
+                               q->queue_length, results->num_fulfilled,
+                               results->num_unfulfilled,
+                               results->num_timed_out,
+                               time_slice <= params->closing_time
+                                   ? simulation->arrival_rate
+                                   : 0) != SIMQ_OK)
+    {
+        return SIMQ_ERROR_FILE;
+    }
+    END_PHASE(&results->timings, OUTPUT_PHASE);
+
+    /* Stops the simulation. */
+    time_slice = ++simulation->time_slice;
+    if (time_slice > params->closing_time &&
+        is_branch_empty(q, service_points))
+    {
+        results->time_after_closing += time_slice - params->closing_time - 1;
+        simulation->closed = 1;
+    }
+
+    return SIMQ_OK;
+}
+
+/* Simulates the branch from opening until the last customer has left, adding
+onto the running totals, one time slice after another. Returns an error code
+if there is not enough memory or the records cannot be written. */
+int run_simulation(PARAMETERS *params, SERVICE_POINTS *service_points,
+                   ARENA *arena, gsl_rng *arrival_r, gsl_rng *customer_r,
+                   RESULTS *results, OUTPUT *output)
+{
+    SIMULATION simulation;
+    int error = start_simulation(&simulation, params, service_points, arena,
+                                 arrival_r, customer_r, results, output);
+
+    while (error == SIMQ_OK && !simulation.closed)
+    {
+        error = step_simulation(&simulation);
+    }
+
+    return error;
+}
+
+/* Finds the time a customer arriving at the given time joins the queue. As
+in the time-sliced simulation, a customer arriving during an interval joins
+at the start of the next one, unless the resolution is 0 for continuous
+time. */
+double find_joining_time(double arrival, float resolution)
+{
+    if (resolution == 0)
+    {
+        return arrival;
+    }
+
+    return (floor(arrival / resolution) + 1) * resolution;
+}
+
+/* Finds the time of the next arrival of a class after the given time, at
+the rate of each segment of the arrival schedule in turn. An arrival which
+would be after the end of its segment is drawn again from the end at the
+rate of the next segment, which is exact as the time until the next arrival
+of a Poisson process does not depend on the time since the last. Gives the
+opening hours if no more customers of the class arrive before then. */
+double find_next_arrival(EVENT_SIMULATION *simulation, int customer_class,
+                         double time)
+{
+    PARAMETERS *params = simulation->params;
+    ARRIVAL_SCHEDULE *schedule = &params->schedule;
+    int *segment = &simulation->arrival_segments[customer_class];
+
+    while (time < simulation->opening_hours)
+    {
+        double end = simulation->opening_hours;
+        if (*segment + 1 < schedule->num_segments &&
+            schedule->starts[*segment + 1] < end)
+        {
+            end = schedule->starts[*segment + 1];
+        }
+
+        float rate = params->classes[customer_class].avg_customer_rate *
+                     schedule->multiples[*segment];
+        if (rate > 0)
+        {
+            double arrival = time + gsl_ran_exponential(simulation->arrival_r,
+                                                        1.0 / rate);
+            if (arrival < end)
+            {
+                return arrival;
+            }
+        }
+
+        time = end;
+        if (*segment + 1 < schedule->num_segments)
+        {
+            (*segment)++;
+        }
+    }
+
+    return simulation->opening_hours;
+}
+
+/* Outputs a record for each whole minute before the given time which has not
+had one yet, with the arrival rate of the segment of the arrival schedule
+each minute is in. Returns an error code if a record cannot be written. */
+int output_event_records(EVENT_SIMULATION *simulation, double until)
+{
+    PARAMETERS *params = simulation->params;
+    RESULTS *results = simulation->results;
+
+    while (simulation->next_record < until)
+    {
+        int minute = simulation->next_record;
+        simulation->record_segment = find_schedule_segment(
+            &params->schedule, simulation->record_segment, minute);
+        if (output_interval_record(
+                simulation->output, minute, params->closing_time,
+                simulation->num_being_served, simulation->queue_length,
+                results->num_fulfilled, results->num_unfulfilled,
+                results->num_timed_out,
+                minute <= params->closing_time
+                    ? find_arrival_rate(params, simulation->record_segment)
+                    : 0) != SIMQ_OK)
+        {
+            return SIMQ_ERROR_FILE;
+        }
+        simulation->next_record++;
+    }
+
+    return SIMQ_OK;
+}
+
+/* Moves the arrivals drawn minute by minute on to a segment of the arrival
+schedule, with new generators of the numbers of arrivals in each minute.
+Returns an error code if there is not enough memory for them. */
+int start_minute_segment(EVENT_SIMULATION *simulation, int segment)
+{
+    PARAMETERS *params = simulation->params;
+
+    simulation->segment = segment;
+    simulation->next_segment_start = find_next_segment_start(
+        &params->schedule, segment);
+
+    return create_arrival_generators(params, segment, simulation->arrival_r,
+                                     simulation->arena,
+                                     simulation->arrival_generators);
+}
+
+/* Draws the numbers of customers of each class arriving in each minute from
+the given one until closing time, in the same order as the time-sliced
+simulation, stopping at the first minute anyone arrives in. Those customers
+are scheduled to join together at the start of the next minute. Returns an
+error code if there is not enough memory. */
+int schedule_minute_arrivals(EVENT_SIMULATION *simulation, int minute)
+{
+    PARAMETERS *params = simulation->params;
+
+    for (; minute <= params->closing_time; minute++)
+    {
+        if (minute == simulation->next_segment_start &&
+            start_minute_segment(simulation, simulation->segment + 1) !=
+                SIMQ_OK)
+        {
+            return SIMQ_ERROR_MEMORY;
+        }
+
+        int num_arrivals = 0;
+        int customer_class;
+        for (customer_class = 0; customer_class < params->num_classes;
+             customer_class++)
+        {
+            simulation->arrival_counts[customer_class] = next_variate(
+                simulation->arrival_generators[customer_class]);
+            num_arrivals += simulation->arrival_counts[customer_class];
+        }
+
+        if (num_arrivals > 0)
+        {
+            simulation->arrival_minute = minute;
+            return schedule_event(simulation->list, minute + 1, ARRIVAL, -1,
+                                  -1);
+        }
+    }
+
+    return SIMQ_OK;
+}
+
+/* Adds a customer of a class joining at the given time to the line for
+their priority if there is space, scheduling them to leave once they have
+waited as long as they will tolerate, or marks them as unfulfilled if the
+queue is full. Returns an error code if there is not enough memory. */
+int admit_event_customer(EVENT_SIMULATION *simulation, int customer_class,
+                         double time)
+{
+    PARAMETERS *params = simulation->params;
+    RESULTS *results = simulation->results;
+    CLASS_RESULTS *totals = &results->classes[customer_class];
+
+    results->num_customers++;
+    totals->num_customers++;
+    if (simulation->queue_length == params->max_queue_length)
+    {
+        results->num_unfulfilled++;
+        totals->num_unfulfilled++;
+        return SIMQ_OK;
+    }
+
+    int mins = next_variate(simulation->mins_generators[customer_class]);
+    int tolerance = next_variate(
+        simulation->tolerance_generators[customer_class]);
+    int customer = join_waiting_line(
+        simulation->lines[simulation->levels[customer_class]], time, mins,
+        tolerance, customer_class);
+    if (customer == -1)
+    {
+        return SIMQ_ERROR_MEMORY;
+    }
+    simulation->queue_length++;
+
+    /* As in the time-sliced simulation, the customer leaves at the end of
+    the interval before their tolerance runs out, once anyone starting to be
+    served then has. */
+    if (tolerance > 0)
+    {
+        return schedule_event(simulation->list,
+                              time + tolerance - simulation->resolution,
+                              ABANDONMENT, customer, customer_class);
+    }
+
+    return SIMQ_OK;
+}
+
+/* Schedules the next waiting customer to start being served as soon as a
+service point is available, unless a start is already due. As in the
+time-sliced simulation, at most one customer starts being served a
+minute. Returns an error code if there is not enough memory. */
+int schedule_start(EVENT_SIMULATION *simulation, double time)
+{
+    if (simulation->start_due || simulation->queue_length == 0 ||
+        simulation->num_being_served == simulation->params->num_service_points)
+    {
+        return SIMQ_OK;
+    }
+
+    simulation->start_due = 1;
+    return schedule_event(simulation->list,
+                          time > simulation->next_start
+                              ? time
+                              : simulation->next_start,
+                          START, -1, -1);
+}
+
+/* Serves the customer at the front of the line of the highest priority with
+anyone waiting, if anyone still is. As in the time-sliced simulation, the
+totals of each class count customers as fulfilled once they start being
+served, and a task taking no time leaves the service point free and is not
+counted as fulfilled. Returns an error code if there is not enough
+memory. */
+int start_next_customer(EVENT_SIMULATION *simulation, double time)
+{
+    RESULTS *results = simulation->results;
+    EVENT_CUSTOMER *customer = NULL;
+    int level;
+    for (level = 0; level < simulation->num_levels && customer == NULL;
+         level++)
+    {
+        customer = leave_waiting_line(simulation->lines[level]);
+    }
+    if (customer == NULL)
+    {
+        return SIMQ_OK;
+    }
+    simulation->queue_length--;
+    simulation->next_start = time + 1;
+
+    CLASS_RESULTS *totals = &results->classes[customer->customer_class];
+    results->fulfilled_wait_time += time - customer->joined;
+    totals->fulfilled_wait_time += time - customer->joined;
+    add_sample_value(&results->wait, time - customer->joined);
+
+    if (customer->mins == 0)
+    {
+        simulation->last_left = time;
+        return SIMQ_OK;
+    }
+    simulation->num_being_served++;
+    totals->num_fulfilled++;
+
+    return schedule_event(simulation->list, time + customer->mins, DEPARTURE,
+                          -1, -1);
+}
+
+/* Starts simulating the branch by jumping straight from one event to the
+next, so the time taken depends on the number of customers rather than the
+closing time. Customers arrive as a Poisson process whose rate changes with
+each segment of the arrival schedule, and times are rounded to the
+resolution in the same way as the time-sliced simulation when it is 1. With
+a resolution of 1, the numbers arriving each minute are also drawn in the
+same way, so that both engines give the same results for the same random
+numbers. The events, waiting line and generators of random numbers are
+taken from the arena. Arrivals and customers are drawn from separate random
+number generators. A record is output for each whole minute if an output is
+given. Returns an error code if there is not enough memory. */
+int start_event_simulation(EVENT_SIMULATION *simulation, PARAMETERS *params,
+                           float resolution, ARENA *arena,
+                           gsl_rng *arrival_r, gsl_rng *customer_r,
+                           RESULTS *results, OUTPUT *output)
+{
+    simulation->params = params;
+    simulation->resolution = resolution;
+    simulation->arrival_r = arrival_r;
+    simulation->arena = arena;
+    simulation->results = results;
+    simulation->output = output;
+    simulation->num_being_served = 0;
+    simulation->queue_length = 0;
+    simulation->next_record = 0;
+    simulation->record_segment = 0;
+    simulation->start_due = 0;
+    simulation->last_left = 0;
+    simulation->next_start = 0;
+    simulation->opening_hours = params->closing_time + 1;
+    simulation->closed = 0;
+    simulation->num_levels = find_priority_levels(
+        params->classes, params->num_classes, simulation->levels);
+
+    if (!(simulation->list = create_event_list(arena)) ||
+        create_class_generators(params, customer_r, arena,
+                                simulation->mins_generators,
+                                simulation->tolerance_generators) != SIMQ_OK)
+    {
+        return SIMQ_ERROR_MEMORY;
+    }
+
+    int level;
+    for (level = 0; level < simulation->num_levels; level++)
+    {
+        if (!(simulation->lines[level] = create_waiting_line(arena)))
+        {
+            return SIMQ_ERROR_MEMORY;
+        }
+    }
+
+    if (resolution == 1)
+    {
+        if (start_minute_segment(simulation, 0) != SIMQ_OK)
+        {
+            return SIMQ_ERROR_MEMORY;
+        }
+        return schedule_minute_arrivals(simulation, 0);
+    }
+
+    /* Schedules the first arrival of each class, if any customers of it
+    arrive at all. */
+    double *arrivals = simulation->arrivals;
+    int customer_class;
+    for (customer_class = 0; customer_class < params->num_classes;
+         customer_class++)
+    {
+        simulation->arrival_segments[customer_class] = 0;
+        arrivals[customer_class] = find_next_arrival(simulation,
+                                                     customer_class, 0);
+        if (arrivals[customer_class] < simulation->opening_hours &&
+            schedule_event(simulation->list,
+                           find_joining_time(arrivals[customer_class],
+                                             resolution),
+                           ARRIVAL, -1, customer_class) != SIMQ_OK)
+        {
+            return SIMQ_ERROR_MEMORY;
+        }
+    }
+
+    return SIMQ_OK;
+}
+
+/* Handles the next event, closing the branch once there are none left.
+Returns an error code if there is not enough memory for the events it
+schedules or the customers who arrive, or a record cannot be written. */
+int step_event_simulation(EVENT_SIMULATION *simulation)
+{
+    PARAMETERS *params = simulation->params;
+    RESULTS *results = simulation->results;
+    EVENT_LIST *list = simulation->list;
+    float resolution = simulation->resolution;
+    EVENT event;
+
+    if (!next_event(list, &event))
+    {
+        return finish_event_simulation(simulation);
+    }
+
+    /* Displays the records for the minutes which have passed, unless the
+    last customer has already left, when only events which change nothing
+    are left and the records up to then are displayed once they are done.
+    With a resolution of 1, customers joining now arrived in the last
+    minute, so its record waits until they have been added, as in the
+    time-sliced simulation. */
+    int minute_arrivals = event.type == ARRIVAL && resolution == 1;
+    int branch_empty = event.time > simulation->opening_hours &&
+                       simulation->queue_length == 0 &&
+                       simulation->num_being_served == 0;
+    if (simulation->output != NULL && !branch_empty &&
+        output_event_records(simulation, event.time - minute_arrivals) !=
+            SIMQ_OK)
+    {
+        return SIMQ_ERROR_FILE;
+    }
+
+    int customer_class = event.customer_class;
+    int error = SIMQ_OK;
+    if (minute_arrivals)
+    {
+        /* Adds the customers of each class who arrived in the last minute
+        in turn, then draws the next minute anyone arrives in. */
+        for (customer_class = 0;
+             customer_class < params->num_classes && error == SIMQ_OK;
+             customer_class++)
+        {
+            int customer;
+            for (customer = 0;
+                 customer < simulation->arrival_counts[customer_class] &&
+                 error == SIMQ_OK;
+                 customer++)
+            {
+                error = admit_event_customer(simulation, customer_class,
+                                             event.time);
+            }
+        }
+        if (error == SIMQ_OK && simulation->output != NULL)
+        {
+            error = output_event_records(simulation, event.time);
+        }
+        if (error == SIMQ_OK)
+        {
+            error = schedule_minute_arrivals(simulation,
+                                             simulation->arrival_minute + 1);
+        }
+    }
+    else if (event.type == ARRIVAL)
+    {
+        error = admit_event_customer(simulation, customer_class, event.time);
+
+        /* Schedules the next arrival of the class if not past closing
+        time. */
+        double *arrival = &simulation->arrivals[customer_class];
+        *arrival = find_next_arrival(simulation, customer_class, *arrival);
+        if (error == SIMQ_OK && *arrival < simulation->opening_hours)
+        {
+            error = schedule_event(list,
+                                   find_joining_time(*arrival, resolution),
+                                   ARRIVAL, -1, customer_class);
+        }
+    }
+    else if (event.type == DEPARTURE)
+    {
+        results->num_fulfilled++;
+        simulation->num_being_served--;
+        simulation->last_left = event.time;
+    }
+    else if (event.type == START)
+    {
+        simulation->start_due = 0;
+        error = start_next_customer(simulation, event.time);
+    }
+    else if (event.type == ABANDONMENT)
+    {
+        /* Removes the customer if they have not been served yet. */
+        WAITING_LINE *line =
+            simulation->lines[simulation->levels[customer_class]];
+        EVENT_CUSTOMER *customer = find_waiting_customer(line,
+                                                         event.customer);
+        if (customer != NULL)
+        {
+            customer->waiting = 0;
+            line->queue_length--;
+            simulation->queue_length--;
+            results->num_timed_out++;
+            results->classes[customer_class].num_timed_out++;
+            add_running_value(&results->timed_out_wait,
+                              event.time - customer->joined);
+            simulation->last_left = event.time;
+        }
+    }
+
+    if (error != SIMQ_OK)
+    {
+        return error;
+    }
+
+    /* Schedules the next customer to start being served if anyone is
+    waiting for a service point which is available. */
+    return schedule_start(simulation, event.time);
+}
+
+/* Closes the branch once the last customer has left, adding the time after
+closing onto the running totals and displaying the records up to then.
+Returns an error code if a record cannot be written. */
+int finish_event_simulation(EVENT_SIMULATION *simulation)
+{
+    PARAMETERS *params = simulation->params;
+
+    /* Rounds up to whole minutes after closing, as in the time-sliced
+    simulation. */
+    int time_after_closing = ceil(simulation->last_left) -
+                             params->closing_time;
+    if (time_after_closing < 0)
+    {
+        time_after_closing = 0;
+    }
+    simulation->results->time_after_closing += time_after_closing;
+
+    /* Displays the records up to the time the last customer left. */
+    simulation->closed = 1;
+    if (simulation->output != NULL)
+    {
+        return output_event_records(simulation, params->closing_time +
+                                                    time_after_closing + 1);
+    }
+
+    return SIMQ_OK;
+}
+
+/* Simulates the branch from opening until the last customer has left by
+jumping from one event to the next, adding onto the running totals. Returns
+an error code if there is not enough memory. */
+int run_event_simulation(PARAMETERS *params, float resolution, ARENA *arena,
+                         gsl_rng *arrival_r, gsl_rng *customer_r,
+                         RESULTS *results, OUTPUT *output)
+{
+    EVENT_SIMULATION simulation;
+    int error = start_event_simulation(&simulation, params, resolution,
+                                       arena, arrival_r, customer_r, results,
+                                       output);
+
+    while (error == SIMQ_OK && !simulation.closed)
+    {
+        error = step_event_simulation(&simulation);
+    }
+
+    return error;
+}
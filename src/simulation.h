@@ -0,0 +1,146 @@
+/* Header file for running a single simulation of a Post Office branch. */
+#ifndef __SIMULATION_H
+#define __SIMULATION_H
+
+#include <errno.h>
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_randist.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <arena.h>
+#include <errors.h>
+#include <events.h>
+#include <input_output.h>
+#include <phase_timing.h>
+#include <queue.h>
+#include <random_numbers.h>
+#include <service_points.h>
+#include <stats.h>
+
+/* Parameters structure holding the configuration from the input file. The
+first class of customer is the standard class, which takes its values from
+the main parameters and has a priority of 0. The arrival schedule scales the
+rates of every class through the day. */
+struct parameters
+{
+    int max_queue_length, num_service_points, closing_time, num_classes;
+    float avg_customer_rate, mean_mins, std_dev_mins, mean_tolerance,
+        std_dev_tolerance;
+    CUSTOMER_CLASS classes[MAX_CUSTOMER_CLASSES];
+    ARRIVAL_SCHEDULE schedule;
+};
+typedef struct parameters PARAMETERS;
+
+/* Results structure holding the running totals across simulations and for
+each class of customer, along with statistics of the waiting time of each
+customer, and of the results of each simulation and antithetic pair for the
+spread between them, and the time spent in each phase if it is timed. */
+struct results
+{
+    long num_customers, num_fulfilled, num_unfulfilled, num_timed_out,
+        time_after_closing;
+    double fulfilled_wait_time;
+    CLASS_RESULTS classes[MAX_CUSTOMER_CLASSES];
+    SAMPLE_STATS wait;
+    RUNNING_STATS timed_out_wait, simulation_fulfilled,
+        simulation_unfulfilled, simulation_timed_out, simulation_wait,
+        pair_wait;
+    PHASE_TIMINGS timings;
+};
+typedef struct results RESULTS;
+
+/* Simulation structure holding the state of a time-sliced simulation between
+one time slice and the next, which is closed once it is past closing time
+and the last customer has left. The generators of arrivals are those of the
+segment of the arrival schedule the time slice is in, which are replaced at
+the start of the next segment. */
+struct simulation
+{
+    PARAMETERS *params;
+    SERVICE_POINTS *service_points;
+    QUEUE *q;
+    ARENA *arena;
+    gsl_rng *arrival_r;
+    VARIATE_GENERATOR *arrival_generators[MAX_CUSTOMER_CLASSES],
+        *mins_generators[MAX_CUSTOMER_CLASSES],
+        *tolerance_generators[MAX_CUSTOMER_CLASSES];
+    RESULTS *results;
+    OUTPUT *output;
+    int time_slice, closed, segment, next_segment_start;
+    float arrival_rate;
+};
+typedef struct simulation SIMULATION;
+
+/* Event simulation structure holding the state of an event-driven
+simulation between one event and the next, with the waiting line of each
+priority level and the time and segment of the arrival schedule of the next
+arrival of each class. With a resolution of 1, the numbers of each class
+arriving in the next minute with any arrivals are held instead, along with
+the generators of the segment it is in. The next customer can start being
+served from the given time, and one is due to if a start is scheduled. It
+is closed once there are no events left. */
+struct event_simulation
+{
+    PARAMETERS *params;
+    float resolution;
+    gsl_rng *arrival_r;
+    ARENA *arena;
+    EVENT_LIST *list;
+    WAITING_LINE *lines[MAX_CUSTOMER_CLASSES];
+    int levels[MAX_CUSTOMER_CLASSES];
+    VARIATE_GENERATOR *arrival_generators[MAX_CUSTOMER_CLASSES],
+        *mins_generators[MAX_CUSTOMER_CLASSES],
+        *tolerance_generators[MAX_CUSTOMER_CLASSES];
+    double arrivals[MAX_CUSTOMER_CLASSES];
+    int arrival_segments[MAX_CUSTOMER_CLASSES];
+    int arrival_counts[MAX_CUSTOMER_CLASSES];
+    int arrival_minute, segment, next_segment_start;
+    RESULTS *results;
+    OUTPUT *output;
+    int num_levels, num_being_served, queue_length, next_record,
+        record_segment, start_due, closed;
+    double last_left, next_start, opening_hours;
+};
+typedef struct event_simulation EVENT_SIMULATION;
+
+/* Simulation function prototypes. */
+void set_parameters(PARAMETERS *, float *);
+void add_customer_classes(PARAMETERS *, PARAMETERS *);
+void create_empty_results(RESULTS *);
+void merge_results(RESULTS *, RESULTS *);
+double find_average_wait(RESULTS *);
+double find_variance_reduction(RESULTS *);
+double find_relative_half_width(RUNNING_STATS *);
+double find_precision_ratio(RESULTS *, float);
+float find_arrival_rate(PARAMETERS *, int);
+int create_class_generators(PARAMETERS *, gsl_rng *, ARENA *,
+                            VARIATE_GENERATOR **, VARIATE_GENERATOR **);
+int find_next_segment_start(ARRIVAL_SCHEDULE *, int);
+int create_arrival_generators(PARAMETERS *, int, gsl_rng *, ARENA *,
+                              VARIATE_GENERATOR **);
+int start_arrival_segment(SIMULATION *, int);
+int start_simulation(SIMULATION *, PARAMETERS *, SERVICE_POINTS *, ARENA *,
+                     gsl_rng *, gsl_rng *, RESULTS *, OUTPUT *);
+int step_simulation(SIMULATION *);
+int run_simulation(PARAMETERS *, SERVICE_POINTS *, ARENA *, gsl_rng *,
+                   gsl_rng *, RESULTS *, OUTPUT *);
+double find_joining_time(double, float);
+double find_next_arrival(EVENT_SIMULATION *, int, double);
+int output_event_records(EVENT_SIMULATION *, double);
+int start_minute_segment(EVENT_SIMULATION *, int);
+int schedule_minute_arrivals(EVENT_SIMULATION *, int);
+int admit_event_customer(EVENT_SIMULATION *, int, double);
+int schedule_start(EVENT_SIMULATION *, double);
+int start_next_customer(EVENT_SIMULATION *, double);
+int start_event_simulation(EVENT_SIMULATION *, PARAMETERS *, float, ARENA *,
+                           gsl_rng *, gsl_rng *, RESULTS *, OUTPUT *);
+int step_event_simulation(EVENT_SIMULATION *);
+int finish_event_simulation(EVENT_SIMULATION *);
+int run_event_simulation(PARAMETERS *, float, ARENA *, gsl_rng *, gsl_rng *,
+                         RESULTS *, OUTPUT *);
+
+#endif
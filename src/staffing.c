@@ -0,0 +1,274 @@
+/* Finds the fewest service points which meet targets for the service
+customers get, searching over the numbers of service points instead of
+simulating every one of them. */
+#include <staffing.h>
+
+/* Names of the targets, as they appear in the staffing file. */
+static const char *target_names[NUM_TARGETS] = {
+    "maxAverageWait", "maxTimedOutShare", "maxUnfulfilledShare"};
+
+/* Reads the targets from a file, where each line has the name of a target
+followed by its value, which is the most the average waiting time of
+fulfilled customers, or the share of customers timing out or unfulfilled,
+can be. A line with numServicePoints followed by the first and last values
+sets the range searched over, and one with maxQueueLength followed by its
+first value, last value and step finds the fewest service points for each
+maximum queue length in the range. Otherwise the maximum queue length is
+the one from the input file. */
+void read_staffing_file(char *staffing_file, float *parameters,
+                        STAFFING *staffing)
+{
+    FILE *fp;
+    char name[64];
+    float value, end, step;
+    int target, first, last, num_targets = 0;
+
+    for (target = 0; target < NUM_TARGETS; target++)
+    {
+        staffing->targets[target] = -1;
+    }
+    staffing->first_points = 1;
+    staffing->last_points = DEFAULT_MAX_SERVICE_POINTS;
+    staffing->first_queue_length = parameters[0];
+    staffing->queue_length_step = 0;
+    staffing->num_queue_lengths = 1;
+
+    /* Opens the staffing file to read from it. */
+    if ((fp = fopen(staffing_file, "r")) == NULL)
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    while (fscanf(fp, "%63s", name) == 1)
+    {
+        if (strcmp(name, "numServicePoints") == 0)
+        {
+            if (fscanf(fp, "%d %d", &first, &last) != 2 || first < 1 ||
+                last < first)
+            {
+                fprintf(stderr, "The range of service points must be a "
+                                "first value of at least 1 followed by a "
+                                "last value no lower!\n");
+                exit(EXIT_FAILURE);
+            }
+            staffing->first_points = first;
+            staffing->last_points = last;
+            continue;
+        }
+
+        if (strcmp(name, "maxQueueLength") == 0)
+        {
+            if (fscanf(fp, "%f %f %f", &value, &end, &step) != 3 ||
+                value < -1 || step <= 0 || end < value)
+            {
+                fprintf(stderr, "The range of maximum queue lengths must be "
+                                "a first value of at least -1 followed by a "
+                                "last value no lower and a step above 0!\n");
+                exit(EXIT_FAILURE);
+            }
+            staffing->first_queue_length = value;
+            staffing->queue_length_step = step;
+            staffing->num_queue_lengths = floor((end - value) / step +
+                                                1e-6) +
+                                          1;
+            continue;
+        }
+
+        for (target = 0; target < NUM_TARGETS; target++)
+        {
+            if (strcmp(name, target_names[target]) == 0)
+            {
+                break;
+            }
+        }
+
+        /* Checks the line names a target and has a valid value, where the
+        shares are at most 1. */
+        if (target == NUM_TARGETS || fscanf(fp, "%f", &value) != 1 ||
+            value < 0 || (target != WAIT_TARGET && value > 1))
+        {
+            fprintf(stderr, "Each line of the staffing file must have the "
+                            "name of a target followed by a valid value, or "
+                            "a range of service points or maximum queue "
+                            "lengths!\n");
+            exit(EXIT_FAILURE);
+        }
+        staffing->targets[target] = value;
+        num_targets++;
+    }
+
+    fclose(fp);
+
+    if (num_targets == 0)
+    {
+        fprintf(stderr, "The staffing file must set at least one target!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Checks the results of the simulations so far against the targets. They
+are met once the confidence interval of every result with a target is
+within it, and missed as soon as that of any result is entirely above it,
+so that clear cases stop early. Otherwise it is unclear, unless these are
+the last simulations, when the averages alone decide. The shares of
+customers are found from the average numbers per simulation. */
+int check_targets(STAFFING *staffing, RESULTS *results, int last)
+{
+    RUNNING_STATS *stats[NUM_TARGETS];
+    stats[WAIT_TARGET] = &results->simulation_wait;
+    stats[TIMED_OUT_TARGET] = &results->simulation_timed_out;
+    stats[UNFULFILLED_TARGET] = &results->simulation_unfulfilled;
+
+    double num_customers = results->simulation_wait.count > 0
+                               ? (double)results->num_customers /
+                                     results->simulation_wait.count
+                               : 0;
+    int outcome = TARGETS_MET;
+    int target;
+    for (target = 0; target < NUM_TARGETS; target++)
+    {
+        if (staffing->targets[target] < 0)
+        {
+            continue;
+        }
+
+        double mean = stats[target]->mean;
+        double half_width = last ? 0 : find_confidence_half_width(
+                                           stats[target]);
+        if (target != WAIT_TARGET)
+        {
+            mean = num_customers > 0 ? mean / num_customers : 0;
+            half_width = num_customers > 0 ? half_width / num_customers : 0;
+        }
+
+        if (mean - half_width > staffing->targets[target])
+        {
+            return TARGETS_MISSED;
+        }
+        if (mean + half_width > staffing->targets[target])
+        {
+            outcome = TARGETS_UNCLEAR;
+        }
+    }
+
+    return outcome;
+}
+
+/* Simulates a number of service points in batches which double in size,
+stopping as soon as it clearly meets or misses the targets, or once the
+number of simulations given has been run. Every number of service points is
+given the same random numbers, which are those of a run with the same seed,
+so the differences between them are not hidden by chance. Returns whether
+the targets are met, along with the results and the number of simulations
+run. */
+int try_service_points(STAFFING *staffing, PARAMETERS *params,
+                       OPTIONS *options, RESULTS *results,
+                       int *num_simulations)
+{
+    int max_simulations = options->num_simulations;
+    int batch_size = MIN_SEQUENTIAL_SIMULATIONS;
+    int outcome = TARGETS_UNCLEAR;
+    long num_heap_allocations = 0;
+    long num_later_heap_allocations = 0;
+
+    create_empty_results(results);
+    *num_simulations = 0;
+    while (outcome == TARGETS_UNCLEAR)
+    {
+        int last = *num_simulations + batch_size;
+        if (last > max_simulations)
+        {
+            last = max_simulations;
+        }
+        exit_on_error(run_batch(params, options, *num_simulations, last,
+                                results, NULL, NULL, &num_heap_allocations,
+                                &num_later_heap_allocations));
+        batch_size = last;
+        *num_simulations = last;
+        outcome = check_targets(staffing, results, last == max_simulations);
+    }
+
+    return outcome;
+}
+
+/* Finds the fewest service points which meet the targets for each maximum
+queue length, by bisection over the range of service points, taking more
+service points never to make the service worse. Outputs a table with a row
+for each maximum queue length, giving the number of service points found
+and their averages, or none if even the most in the range miss the targets,
+along with how many numbers of service points and simulations were tried.
+Every number of service points has the same extra classes of customer and
+arrival schedule as the base parameters. */
+void find_staffing(STAFFING *staffing, float *parameters,
+                   PARAMETERS *base_params, OPTIONS *options, OUTPUT *output)
+{
+    RESULTS *results = NULL, *best = NULL;
+    if (!(results = (RESULTS *)malloc(sizeof(RESULTS))) ||
+        !(best = (RESULTS *)malloc(sizeof(RESULTS))))
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    output_staffing_header(output);
+    int queue_length;
+    for (queue_length = 0; queue_length < staffing->num_queue_lengths;
+         queue_length++)
+    {
+        float values[NUM_PARAMETERS];
+        memcpy(values, parameters, sizeof(values));
+        values[0] = staffing->first_queue_length +
+                    queue_length * staffing->queue_length_step;
+
+        /* Narrows the range down to the fewest service points meeting the
+        targets, starting by checking the most do. */
+        int low = staffing->first_points, high = staffing->last_points;
+        int num_tried = 0, num_simulations = 0, best_simulations = 0;
+        int found = 0;
+        int points = high;
+        create_empty_results(best);
+        while (low <= high)
+        {
+            PARAMETERS params;
+            int candidate_simulations;
+            values[1] = points;
+            set_parameters(&params, values);
+            add_customer_classes(&params, base_params);
+            params.schedule = base_params->schedule;
+
+            int outcome = try_service_points(staffing, &params, options,
+                                             results,
+                                             &candidate_simulations);
+            num_tried++;
+            num_simulations += candidate_simulations;
+            if (outcome == TARGETS_MET)
+            {
+                *best = *results;
+                best_simulations = candidate_simulations;
+                found = points;
+                high = points - 1;
+            }
+            else
+            {
+                low = points + 1;
+            }
+
+            /* Stops if even the most service points miss the targets. */
+            if (!found)
+            {
+                break;
+            }
+            points = low + (high - low) / 2;
+        }
+
+        output_staffing_row(output, values[0], found, num_tried,
+                            num_simulations, best_simulations,
+                            best->num_fulfilled, best->fulfilled_wait_time,
+                            best->num_unfulfilled, best->num_timed_out,
+                            best->time_after_closing);
+    }
+
+    free(best);
+    free(results);
+}
@@ -0,0 +1,55 @@
+/* Header file for finding the fewest service points which meet targets for
+the service customers get, searching over the numbers of service points
+instead of simulating every one of them. */
+#ifndef __STAFFING_H
+#define __STAFFING_H
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <input_output.h>
+#include <options.h>
+#include <replications.h>
+#include <simulation.h>
+#include <stats.h>
+
+/* Largest number of service points searched up to, unless the staffing
+file gives a range. */
+#define DEFAULT_MAX_SERVICE_POINTS 100
+
+/* Number of targets which can be set in the staffing file. */
+#define NUM_TARGETS 3
+#define WAIT_TARGET 0
+#define TIMED_OUT_TARGET 1
+#define UNFULFILLED_TARGET 2
+
+/* Outcomes of checking the results of a number of service points against
+the targets. */
+#define TARGETS_MET 1
+#define TARGETS_MISSED 0
+#define TARGETS_UNCLEAR -1
+
+/* Staffing structure holding the targets, which are below 0 if they are not
+set, and the ranges of the numbers of service points and maximum queue
+lengths searched over. The fewest service points are found for each
+maximum queue length. */
+struct staffing
+{
+    float targets[NUM_TARGETS];
+    int first_points, last_points;
+    float first_queue_length, queue_length_step;
+    int num_queue_lengths;
+};
+typedef struct staffing STAFFING;
+
+/* Staffing function prototypes. */
+void read_staffing_file(char *, float *, STAFFING *);
+int check_targets(STAFFING *, RESULTS *, int);
+int try_service_points(STAFFING *, PARAMETERS *, OPTIONS *, RESULTS *,
+                       int *);
+void find_staffing(STAFFING *, float *, PARAMETERS *, OPTIONS *, OUTPUT *);
+
+#endif
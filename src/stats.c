@@ -0,0 +1,363 @@
+/* Keeps statistics of a stream of values in constant memory, without
+storing the values themselves. */
+#include <stats.h>
+
+/* Sets the running statistics to those of no values. */
+void create_running_stats(RUNNING_STATS *stats)
+{
+    stats->count = 0;
+    stats->mean = 0;
+    stats->sum_squared_deviations = 0;
+}
+
+/* Adds a value onto the running statistics using Welford's method. */
+void add_running_value(RUNNING_STATS *stats, double value)
+{
+    stats->count++;
+    double delta = value - stats->mean;
+    stats->mean += delta / stats->count;
+    stats->sum_squared_deviations += delta * (value - stats->mean);
+}
+
+/* Adds the running statistics of one set of values onto another, as if
+every value had been added one at a time. */
+void merge_running_stats(RUNNING_STATS *total, RUNNING_STATS *stats)
+{
+    if (stats->count == 0)
+    {
+        return;
+    }
+
+    long count = total->count + stats->count;
+    double delta = stats->mean - total->mean;
+    total->mean += delta * stats->count / count;
+    total->sum_squared_deviations += stats->sum_squared_deviations +
+                                     delta * delta * total->count *
+                                         stats->count / count;
+    total->count = count;
+}
+
+/* Finds the sample variance of the values, which is 0 for fewer than two. */
+double find_variance(RUNNING_STATS *stats)
+{
+    if (stats->count < 2)
+    {
+        return 0;
+    }
+
+    return stats->sum_squared_deviations / (stats->count - 1);
+}
+
+/* Finds the standard error of the mean of the values. */
+double find_standard_error(RUNNING_STATS *stats)
+{
+    if (stats->count < 2)
+    {
+        return 0;
+    }
+
+    return sqrt(find_variance(stats) / stats->count);
+}
+
+/* Finds the half-width of the confidence interval of the mean of the
+values, using the t distribution. */
+double find_confidence_half_width(RUNNING_STATS *stats)
+{
+    if (stats->count < 2)
+    {
+        return 0;
+    }
+
+    return gsl_cdf_tdist_Pinv((1 + CONFIDENCE_LEVEL) / 2, stats->count - 1) *
+           find_standard_error(stats);
+}
+
+/* Sets the digest to that of no values. */
+void create_digest(DIGEST *digest)
+{
+    digest->num_centroids = 0;
+    digest->num_buffered = 0;
+    digest->total_weight = 0;
+    digest->min = 0;
+    digest->max = 0;
+}
+
+/* Adds a value with the given weight onto the digest, compressing it if
+the buffer is full. */
+void add_digest_value(DIGEST *digest, double value, double weight)
+{
+    if (digest->total_weight == 0 || value < digest->min)
+    {
+        digest->min = value;
+    }
+    if (digest->total_weight == 0 || value > digest->max)
+    {
+        digest->max = value;
+    }
+
+    CENTROID *centroid = &digest->centroids[digest->num_centroids +
+                                            digest->num_buffered++];
+    centroid->mean = value;
+    centroid->weight = weight;
+    digest->total_weight += weight;
+
+    if (digest->num_buffered == DIGEST_BUFFER_SIZE)
+    {
+        compress_digest(digest);
+    }
+}
+
+/* Adds every centroid of one digest onto another. */
+void merge_digests(DIGEST *total, DIGEST *digest)
+{
+    if (digest->total_weight == 0)
+    {
+        return;
+    }
+
+    double min = digest->min;
+    double max = digest->max;
+    if (total->total_weight > 0)
+    {
+        min = total->min < min ? total->min : min;
+        max = total->max > max ? total->max : max;
+    }
+
+    int centroid;
+    for (centroid = 0;
+         centroid < digest->num_centroids + digest->num_buffered; centroid++)
+    {
+        add_digest_value(total, digest->centroids[centroid].mean,
+                         digest->centroids[centroid].weight);
+    }
+    total->min = min;
+    total->max = max;
+}
+
+/* Compares two centroids by their means, for sorting. */
+int compare_centroids(const void *first, const void *second)
+{
+    double first_mean = ((CENTROID *)first)->mean;
+    double second_mean = ((CENTROID *)second)->mean;
+
+    return (first_mean > second_mean) - (first_mean < second_mean);
+}
+
+/* Finds the scale of a quantile, which changes quickly near the tails so
+that centroids there cover fewer values. */
+double find_digest_scale(double quantile)
+{
+    return DIGEST_COMPRESSION / (2 * PI) * asin(2 * quantile - 1);
+}
+
+/* Finds the furthest quantile a centroid starting at the given quantile can
+reach, which is one step of the scale further on. */
+double find_digest_quantile_limit(double quantile)
+{
+    double scale = find_digest_scale(quantile) + 1;
+    if (scale >= DIGEST_COMPRESSION / 4.0)
+    {
+        return 1;
+    }
+
+    return (sin(scale * 2 * PI / DIGEST_COMPRESSION) + 1) / 2;
+}
+
+/* Sorts the centroids and buffered values together, then merges neighbours
+for as long as each centroid stays within one step of the scale. */
+void compress_digest(DIGEST *digest)
+{
+    int num_centroids = digest->num_centroids + digest->num_buffered;
+    if (num_centroids == 0)
+    {
+        return;
+    }
+    qsort(digest->centroids, num_centroids, sizeof(CENTROID),
+          compare_centroids);
+
+    CENTROID current = digest->centroids[0];
+    double weight_before = 0;
+    double limit = find_digest_quantile_limit(0);
+    int num_merged = 0;
+    int centroid;
+    for (centroid = 1; centroid < num_centroids; centroid++)
+    {
+        CENTROID *next = &digest->centroids[centroid];
+        double quantile = (weight_before + current.weight + next->weight) /
+                          digest->total_weight;
+
+        if (quantile <= limit)
+        {
+            current.weight += next->weight;
+            current.mean += (next->mean - current.mean) * next->weight /
+                            current.weight;
+        }
+        else
+        {
+            digest->centroids[num_merged++] = current;
+            weight_before += current.weight;
+            limit = find_digest_quantile_limit(weight_before /
+                                               digest->total_weight);
+            current = *next;
+        }
+    }
+    digest->centroids[num_merged++] = current;
+
+    digest->num_centroids = num_merged;
+    digest->num_buffered = 0;
+}
+
+/* Estimates a quantile of the values by interpolating between the middles of
+the centroids either side of it, or the smallest or largest value at the
+ends. */
+double find_quantile(DIGEST *digest, double quantile)
+{
+    compress_digest(digest);
+    if (digest->num_centroids == 0)
+    {
+        return 0;
+    }
+
+    double target = quantile * digest->total_weight;
+    double previous_middle = 0;
+    double previous_mean = digest->min;
+    double weight_before = 0;
+    int centroid;
+    for (centroid = 0; centroid < digest->num_centroids; centroid++)
+    {
+        CENTROID *current = &digest->centroids[centroid];
+        double middle = weight_before + current->weight / 2;
+        if (target < middle)
+        {
+            if (middle == previous_middle)
+            {
+                return current->mean;
+            }
+            return previous_mean + (current->mean - previous_mean) *
+                                       (target - previous_middle) /
+                                       (middle - previous_middle);
+        }
+        previous_middle = middle;
+        previous_mean = current->mean;
+        weight_before += current->weight;
+    }
+
+    /* Interpolates between the last middle and the largest value. */
+    if (digest->total_weight == previous_middle)
+    {
+        return digest->max;
+    }
+    return previous_mean + (digest->max - previous_mean) *
+                               (target - previous_middle) /
+                               (digest->total_weight - previous_middle);
+}
+
+/* Sets the histogram to that of no values. */
+void create_histogram(HISTOGRAM *histogram)
+{
+    histogram->total_count = 0;
+    histogram->num_values = 0;
+    histogram->exact = 1;
+}
+
+/* Counts a value in the histogram if it is a whole number it has room for,
+or stops it being exact otherwise. Counts above the largest value so far
+are cleared as they come into use. */
+void add_histogram_value(HISTOGRAM *histogram, double value)
+{
+    if (!histogram->exact)
+    {
+        return;
+    }
+    if (value < 0 || value >= HISTOGRAM_SIZE || value != floor(value))
+    {
+        histogram->exact = 0;
+        return;
+    }
+
+    int whole = (int)value;
+    while (histogram->num_values <= whole)
+    {
+        histogram->counts[histogram->num_values++] = 0;
+    }
+    histogram->counts[whole]++;
+    histogram->total_count++;
+}
+
+/* Adds the counts of one histogram onto another, which is only exact if
+both of them are. */
+void merge_histograms(HISTOGRAM *total, HISTOGRAM *histogram)
+{
+    if (!total->exact || !histogram->exact)
+    {
+        total->exact = 0;
+        return;
+    }
+
+    while (total->num_values < histogram->num_values)
+    {
+        total->counts[total->num_values++] = 0;
+    }
+    int value;
+    for (value = 0; value < histogram->num_values; value++)
+    {
+        total->counts[value] += histogram->counts[value];
+    }
+    total->total_count += histogram->total_count;
+}
+
+/* Finds a quantile of the values exactly, as the value which that share of
+the values counted are below. */
+double find_histogram_quantile(HISTOGRAM *histogram, double quantile)
+{
+    double target = quantile * histogram->total_count;
+    long count_below = 0;
+    int value;
+    for (value = 0; value < histogram->num_values; value++)
+    {
+        count_below += histogram->counts[value];
+        if (target < count_below)
+        {
+            return value;
+        }
+    }
+
+    return histogram->num_values > 0 ? histogram->num_values - 1 : 0;
+}
+
+/* Sets the sample statistics to those of no values. */
+void create_sample_stats(SAMPLE_STATS *stats)
+{
+    create_running_stats(&stats->running);
+    create_digest(&stats->digest);
+    create_histogram(&stats->histogram);
+}
+
+/* Adds a value onto the running statistics, digest and histogram. */
+void add_sample_value(SAMPLE_STATS *stats, double value)
+{
+    add_running_value(&stats->running, value);
+    add_digest_value(&stats->digest, value, 1);
+    add_histogram_value(&stats->histogram, value);
+}
+
+/* Adds the sample statistics of one set of values onto another. */
+void merge_sample_stats(SAMPLE_STATS *total, SAMPLE_STATS *stats)
+{
+    merge_running_stats(&total->running, &stats->running);
+    merge_digests(&total->digest, &stats->digest);
+    merge_histograms(&total->histogram, &stats->histogram);
+}
+
+/* Finds a quantile of the values, exactly from the histogram while every
+value is a whole number it counts, such as the waits of the tick engine,
+or estimated from the digest otherwise. */
+double find_sample_quantile(SAMPLE_STATS *stats, double quantile)
+{
+    if (stats->histogram.exact)
+    {
+        return find_histogram_quantile(&stats->histogram, quantile);
+    }
+
+    return find_quantile(&stats->digest, quantile);
+}
@@ -0,0 +1,106 @@
+/* Header file for keeping statistics of a stream of values in constant
+memory, without storing the values themselves. */
+#ifndef __STATS_H
+#define __STATS_H
+
+#include <gsl/gsl_cdf.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Ratio of the circumference of a circle to its diameter, which the math
+library only defines outside of ANSI C. */
+#define PI 3.14159265358979323846
+
+/* Confidence level of the intervals of the results. */
+#define CONFIDENCE_LEVEL 0.95
+
+/* Compression of the quantile digests, which bounds the number of centroids
+kept to about this many. Higher values give more accurate quantiles. */
+#define DIGEST_COMPRESSION 100
+
+/* Number of centroids a digest has room for once compressed, and the
+number of values it takes in before compressing them again. */
+#define DIGEST_MAX_CENTROIDS 128
+#define DIGEST_BUFFER_SIZE 512
+
+/* Number of whole values from 0 up which a histogram counts exactly. */
+#define HISTOGRAM_SIZE 1024
+
+/* Running statistics structure, holding the count, mean and sum of squared
+deviations from the mean of the values seen so far, which are updated using
+Welford's method to avoid losing precision. */
+struct running_stats
+{
+    long count;
+    double mean, sum_squared_deviations;
+};
+typedef struct running_stats RUNNING_STATS;
+
+/* Centroid structure, for a group of nearby values in a digest. */
+struct centroid
+{
+    double mean, weight;
+};
+typedef struct centroid CENTROID;
+
+/* Digest structure, which estimates quantiles of the values seen so far from
+a bounded number of centroids. Centroids are smaller near the tails so that
+high percentiles stay accurate. New values are buffered after the
+centroids until there are enough to compress them in. */
+struct digest
+{
+    CENTROID centroids[DIGEST_MAX_CENTROIDS + DIGEST_BUFFER_SIZE];
+    int num_centroids, num_buffered;
+    double total_weight, min, max;
+};
+typedef struct digest DIGEST;
+
+/* Histogram structure, counting how many times each whole value below its
+size has been seen, so that their quantiles are exact. It stays exact until
+any other value is seen. Only the counts below the number of values in use
+are kept, so that creating one does not clear them all. */
+struct histogram
+{
+    long counts[HISTOGRAM_SIZE];
+    long total_count;
+    int num_values, exact;
+};
+typedef struct histogram HISTOGRAM;
+
+/* Sample statistics structure, holding the running statistics, digest and
+histogram of the same values. */
+struct sample_stats
+{
+    RUNNING_STATS running;
+    DIGEST digest;
+    HISTOGRAM histogram;
+};
+typedef struct sample_stats SAMPLE_STATS;
+
+/* Statistics function prototypes. */
+void create_running_stats(RUNNING_STATS *);
+void add_running_value(RUNNING_STATS *, double);
+void merge_running_stats(RUNNING_STATS *, RUNNING_STATS *);
+double find_variance(RUNNING_STATS *);
+double find_standard_error(RUNNING_STATS *);
+double find_confidence_half_width(RUNNING_STATS *);
+void create_digest(DIGEST *);
+void add_digest_value(DIGEST *, double, double);
+void merge_digests(DIGEST *, DIGEST *);
+int compare_centroids(const void *, const void *);
+double find_digest_scale(double);
+double find_digest_quantile_limit(double);
+void compress_digest(DIGEST *);
+double find_quantile(DIGEST *, double);
+void create_histogram(HISTOGRAM *);
+void add_histogram_value(HISTOGRAM *, double);
+void merge_histograms(HISTOGRAM *, HISTOGRAM *);
+double find_histogram_quantile(HISTOGRAM *, double);
+void create_sample_stats(SAMPLE_STATS *);
+void add_sample_value(SAMPLE_STATS *, double);
+void merge_sample_stats(SAMPLE_STATS *, SAMPLE_STATS *);
+double find_sample_quantile(SAMPLE_STATS *, double);
+
+#endif
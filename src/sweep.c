@@ -0,0 +1,266 @@
+/* Sweeps over ranges of the parameters, simulating every combination of them
+in one run. */
+#include <sweep.h>
+
+/* Names of the parameters, as they appear in the input file. */
+static const char *const parameter_names[NUM_PARAMETERS] = {
+    "maxQueueLength", "numServicePoints", "closingTime",
+    "averageCustomersPerMinute", "meanMinsPerCustomerTask",
+    "standardDeviationMinsPerCustomerTask", "meanMaxQueueTimePerCustomer",
+    "standardDeviationMaxQueueTimePerCustomer"};
+
+/* Reads the ranges of the parameters to sweep over from a file, where each
+line has the name of a parameter followed by its first value, last value
+and step. Parameters which are not in the file keep their value from the
+input file. The number of scenarios must fit in an int, and their rows of
+results in memory. */
+void read_sweep_file(char *sweep_file, float *parameters, SWEEP *sweep)
+{
+    FILE *fp;
+    char name[64];
+    float start, end, step;
+    double num_values;
+    int parameter;
+
+    /* Starts with the single value from the input file for everything. */
+    for (parameter = 0; parameter < NUM_PARAMETERS; parameter++)
+    {
+        sweep->start[parameter] = parameters[parameter];
+        sweep->step[parameter] = 0;
+        sweep->num_values[parameter] = 1;
+    }
+
+    /* Opens the sweep file to read from it. */
+    if ((fp = fopen(sweep_file, "r")) == NULL)
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    while (fscanf(fp, "%63s", name) == 1)
+    {
+        for (parameter = 0; parameter < NUM_PARAMETERS; parameter++)
+        {
+            if (strcmp(name, parameter_names[parameter]) == 0)
+            {
+                break;
+            }
+        }
+
+        /* Checks the line names a parameter and has a valid range. */
+        if (parameter == NUM_PARAMETERS ||
+            fscanf(fp, "%f %f %f", &start, &end, &step) != 3 || step <= 0 ||
+            end < start)
+        {
+            fprintf(stderr, "Each line of the sweep file must have the name "
+                            "of a parameter followed by its first value, "
+                            "last value and a step above 0!\n");
+            exit(EXIT_FAILURE);
+        }
+
+        num_values = floor((end - start) / step + 1e-6) + 1;
+        if (num_values > INT_MAX)
+        {
+            fprintf(stderr, "The range of %s has too many values!\n",
+                    name);
+            exit(EXIT_FAILURE);
+        }
+        sweep->start[parameter] = start;
+        sweep->step[parameter] = step;
+        sweep->num_values[parameter] = num_values;
+    }
+
+    fclose(fp);
+
+    /* Counts the scenarios, and checks the first and last values of every
+    range are valid in the same way as the input file. */
+    float first[NUM_PARAMETERS], last[NUM_PARAMETERS];
+    sweep->num_scenarios = 1;
+    for (parameter = 0; parameter < NUM_PARAMETERS; parameter++)
+    {
+        if (sweep->num_values[parameter] > INT_MAX / sweep->num_scenarios ||
+            sweep->num_values[parameter] >
+                SIZE_MAX / sizeof(SWEEP_ROW) / sweep->num_scenarios)
+        {
+            fprintf(stderr, "The sweep has too many scenarios!\n");
+            exit(EXIT_FAILURE);
+        }
+        sweep->num_scenarios *= sweep->num_values[parameter];
+        first[parameter] = sweep->start[parameter];
+        last[parameter] = sweep->start[parameter] +
+                          (sweep->num_values[parameter] - 1) *
+                              sweep->step[parameter];
+    }
+    exit_on_error(check_parameter_values(first));
+    exit_on_error(check_parameter_values(last));
+}
+
+/* Finds the values of the parameters for a scenario, counting through the
+combinations with the last parameter changing fastest. */
+void find_scenario_values(SWEEP *sweep, long scenario, float *values)
+{
+    int parameter;
+    for (parameter = NUM_PARAMETERS - 1; parameter >= 0; parameter--)
+    {
+        int value = scenario % sweep->num_values[parameter];
+        scenario /= sweep->num_values[parameter];
+        values[parameter] = sweep->start[parameter] +
+                            value * sweep->step[parameter];
+    }
+}
+
+/* Runs the simulations for one scenario after another, reusing the same
+simulation context for all of them. Each scenario has a seed of its own found
+from the seed of the run, so its results do not depend on which thread
+simulated it. */
+void *run_sweep_worker(void *arg)
+{
+    SWEEP_WORKER *worker = (SWEEP_WORKER *)arg;
+    SWEEP *sweep = worker->sweep;
+
+    SIMQ *simq;
+    SIMQ_CONFIG config;
+    set_simq_config(&config, worker->options);
+    exit_on_error(simq_init(&simq, worker->base_params, &config));
+
+    while (1)
+    {
+        /* Takes the next scenario no other thread has taken. */
+        pthread_mutex_lock(worker->lock);
+        long scenario = (*worker->next_scenario)++;
+        pthread_mutex_unlock(worker->lock);
+        if (scenario >= sweep->num_scenarios)
+        {
+            break;
+        }
+
+        float values[NUM_PARAMETERS];
+        PARAMETERS params;
+        find_scenario_values(sweep, scenario, values);
+        set_parameters(&params, values);
+        add_customer_classes(&params, worker->base_params);
+        params.schedule = worker->base_params->schedule;
+        exit_on_error(simq_set_parameters(
+            simq, &params, simq_derive_seed(worker->options->seed, scenario)));
+
+        int simulation;
+        for (simulation = 0; simulation < worker->options->num_simulations;
+             simulation++)
+        {
+            exit_on_error(simq_run(simq, simulation, NULL));
+        }
+        /* Keeps only the totals the row of the scenario needs. */
+        RESULTS results;
+        simq_results(simq, &results);
+        simq_clear_results(simq);
+        worker->rows[scenario].num_fulfilled = results.num_fulfilled;
+        worker->rows[scenario].num_unfulfilled = results.num_unfulfilled;
+        worker->rows[scenario].num_timed_out = results.num_timed_out;
+        worker->rows[scenario].time_after_closing =
+            results.time_after_closing;
+        worker->rows[scenario].fulfilled_wait_time =
+            results.fulfilled_wait_time;
+    }
+
+    simq_destroy(simq);
+    return NULL;
+}
+
+/* Simulates every scenario in the sweep, sharing them out between the
+threads as they become free, and outputs a table with a row of results for
+each scenario. Every scenario has the same extra classes of customer and
+arrival schedule as the base parameters. */
+void run_sweep(SWEEP *sweep, PARAMETERS *base_params, OPTIONS *options,
+               OUTPUT *output)
+{
+    int num_threads = options->num_threads;
+    if (num_threads > sweep->num_scenarios)
+    {
+        num_threads = sweep->num_scenarios;
+    }
+
+    SWEEP_ROW *rows = NULL;
+    SWEEP_WORKER *workers = NULL;
+    if (!(rows = (SWEEP_ROW *)malloc(sweep->num_scenarios *
+                                     sizeof(SWEEP_ROW))) ||
+        !(workers = (SWEEP_WORKER *)malloc(num_threads *
+                                           sizeof(SWEEP_WORKER))))
+    {
+        fprintf(stderr, "Error %d: %s\n", errno, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    long next_scenario = 0;
+    pthread_mutex_t lock;
+    pthread_mutex_init(&lock, NULL);
+
+    int thread;
+    for (thread = 0; thread < num_threads; thread++)
+    {
+        workers[thread].sweep = sweep;
+        workers[thread].base_params = base_params;
+        workers[thread].options = options;
+        workers[thread].rows = rows;
+        workers[thread].next_scenario = &next_scenario;
+        workers[thread].lock = &lock;
+
+        int error = pthread_create(&workers[thread].thread, NULL,
+                                   run_sweep_worker, &workers[thread]);
+        if (error != 0)
+        {
+            fprintf(stderr, "Error %d: %s\n", error, strerror(error));
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (thread = 0; thread < num_threads; thread++)
+    {
+        pthread_join(workers[thread].thread, NULL);
+    }
+    pthread_mutex_destroy(&lock);
+
+    /* Outputs the results in the same order as the scenarios, with the
+    values of the parameters as they would be given in the input file. */
+    long scenario;
+    output_sweep_header(output);
+    for (scenario = 0; scenario < sweep->num_scenarios; scenario++)
+    {
+        float values[NUM_PARAMETERS];
+        find_scenario_values(sweep, scenario, values);
+        output_sweep_row(output, values[0], values[1], values[2], values[3],
+                         values[4], values[5], values[6], values[7],
+                         options->num_simulations,
+                         rows[scenario].num_fulfilled,
+                         rows[scenario].fulfilled_wait_time,
+                         rows[scenario].num_unfulfilled,
+                         rows[scenario].num_timed_out,
+                         rows[scenario].time_after_closing);
+    }
+
+    free(workers);
+    free(rows);
+}
+
+/* Estimates every scenario in the sweep from queueing theory instead of
+simulating it, which is quick enough to screen a large sweep on one thread
+before simulating the scenarios of interest, and outputs the same table. */
+void run_analytic_sweep(SWEEP *sweep, PARAMETERS *base_params,
+                        OUTPUT *output)
+{
+    long scenario;
+    output_sweep_header(output);
+    for (scenario = 0; scenario < sweep->num_scenarios; scenario++)
+    {
+        float values[NUM_PARAMETERS];
+        PARAMETERS params;
+        ESTIMATE estimate;
+        find_scenario_values(sweep, scenario, values);
+        set_parameters(&params, values);
+        add_customer_classes(&params, base_params);
+        params.schedule = base_params->schedule;
+        estimate_branch(&params, &estimate);
+        output_sweep_estimate_row(output, values, estimate.num_fulfilled,
+                                  estimate.num_unfulfilled,
+                                  estimate.num_timed_out, estimate.mean_wait,
+                                  estimate.time_after_closing);
+    }
+}
@@ -0,0 +1,70 @@
+/* Header file for sweeping over ranges of the parameters, simulating every
+combination of them in one run. */
+#ifndef __SWEEP_H
+#define __SWEEP_H
+
+#include <errno.h>
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_randist.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <analytic.h>
+#include <arena.h>
+#include <cli.h>
+#include <input_output.h>
+#include <options.h>
+#include <replications.h>
+#include <service_points.h>
+#include <libsimq.h>
+#include <simulation.h>
+
+/* Sweep structure holding the range of values for each parameter, in the
+same order as the input file. A parameter which is not swept has a single
+value. */
+struct sweep
+{
+    float start[NUM_PARAMETERS], step[NUM_PARAMETERS];
+    int num_values[NUM_PARAMETERS];
+    long num_scenarios;
+};
+typedef struct sweep SWEEP;
+
+/* Sweep row structure holding the totals across the simulations of a
+scenario which its row of the table is found from, rather than all of its
+results. */
+struct sweep_row
+{
+    long num_fulfilled, num_unfulfilled, num_timed_out, time_after_closing;
+    double fulfilled_wait_time;
+};
+typedef struct sweep_row SWEEP_ROW;
+
+/* Sweep worker structure holding the state owned by a single thread, which
+takes the next scenario from those shared between the threads until there
+are none left. */
+struct sweep_worker
+{
+    SWEEP *sweep;
+    PARAMETERS *base_params;
+    OPTIONS *options;
+    SWEEP_ROW *rows;
+    long *next_scenario;
+    pthread_mutex_t *lock;
+    pthread_t thread;
+};
+typedef struct sweep_worker SWEEP_WORKER;
+
+/* Sweep function prototypes. */
+void read_sweep_file(char *, float *, SWEEP *);
+void find_scenario_values(SWEEP *, long, float *);
+void *run_sweep_worker(void *);
+void run_sweep(SWEEP *, PARAMETERS *, OPTIONS *, OUTPUT *);
+void run_analytic_sweep(SWEEP *, PARAMETERS *, OUTPUT *);
+
+#endif
@@ -0,0 +1,56 @@
+/* Writes binary traces, which hold the record for each time interval of a
+simulation as fixed-width integers. */
+#include <trace.h>
+
+/* Writes the header of a trace with the parameters read from the input
+file, returning an error code if it cannot be written. */
+int write_trace_header(FILE *fp, int max_queue_length,
+                       int num_service_points, int closing_time,
+                       float avg_customer_rate, float mean_mins,
+                       float std_dev_mins, float mean_tolerance,
+                       float std_dev_tolerance)
+{
+    TRACE_HEADER header;
+    memset(&header, 0, sizeof(TRACE_HEADER));
+
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.record_size = sizeof(TRACE_RECORD);
+    header.max_queue_length = max_queue_length;
+    header.num_service_points = num_service_points;
+    header.closing_time = closing_time;
+    header.avg_customer_rate = avg_customer_rate;
+    header.mean_mins = mean_mins;
+    header.std_dev_mins = std_dev_mins;
+    header.mean_tolerance = mean_tolerance;
+    header.std_dev_tolerance = std_dev_tolerance;
+
+    if (fwrite(&header, sizeof(TRACE_HEADER), 1, fp) != 1)
+    {
+        return SIMQ_ERROR_FILE;
+    }
+
+    return SIMQ_OK;
+}
+
+/* Writes the record for a single time interval onto the end of a trace,
+returning an error code if it cannot be written. */
+int write_trace_record(FILE *fp, int time_slice, int num_being_served,
+                       int queue_length, int num_fulfilled,
+                       int num_unfulfilled, int num_timed_out)
+{
+    TRACE_RECORD record;
+    record.time_slice = time_slice;
+    record.num_being_served = num_being_served;
+    record.queue_length = queue_length;
+    record.num_fulfilled = num_fulfilled;
+    record.num_unfulfilled = num_unfulfilled;
+    record.num_timed_out = num_timed_out;
+
+    if (fwrite(&record, sizeof(TRACE_RECORD), 1, fp) != 1)
+    {
+        return SIMQ_ERROR_FILE;
+    }
+
+    return SIMQ_OK;
+}
@@ -0,0 +1,42 @@
+/* Header file for writing binary traces, which hold the record for each
+time interval of a simulation as fixed-width integers. */
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <errors.h>
+
+/* Identifies a file as a trace, followed by the version of the format. */
+#define TRACE_MAGIC "SIMQTRCE"
+#define TRACE_VERSION 1
+
+/* Header structure at the start of a trace, holding the parameters read from
+the input file. */
+struct trace_header
+{
+    char magic[8];
+    int32_t version, record_size;
+    int32_t max_queue_length, num_service_points, closing_time;
+    float avg_customer_rate, mean_mins, std_dev_mins, mean_tolerance,
+        std_dev_tolerance;
+};
+typedef struct trace_header TRACE_HEADER;
+
+/* Record structure for a single time interval, which follow the header one
+after another. */
+struct trace_record
+{
+    int32_t time_slice, num_being_served, queue_length, num_fulfilled,
+        num_unfulfilled, num_timed_out;
+};
+typedef struct trace_record TRACE_RECORD;
+
+/* Trace function prototypes. */
+int write_trace_header(FILE *, int, int, int, float, float, float, float,
+                       float);
+int write_trace_record(FILE *, int, int, int, int, int, int);
+
+#endif